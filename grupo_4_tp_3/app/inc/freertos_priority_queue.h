@@ -9,15 +9,69 @@
 #define INC_FREERTOS_PRIORITY_QUEUE_H_
 
 #include "priority_queue_core.h"
+#include "linked_list.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
 
 typedef struct freertos_pq_opaque* PriorityQueueHandle_t;
 
+// Bloque de control para xPriorityQueueCreateStatic (como StaticQueue_t): mismo
+// tamaño y alineación que la estructura interna, sin exponer sus campos
+typedef struct {
+    priority_queue_core_t dummy1;
+    lli_list_t dummy2[2];
+    size_t dummy3;
+    pq_overflow_policy_t dummy4;
+    bool dummy5[3];
+} StaticPriorityQueue_t;
+
+// Cantidad de pq_slot_t que necesita el arreglo de xPriorityQueueCreateStatic:
+// los slots y las copias de los elementos a continuación
+#define PRIORITY_QUEUE_STORAGE_LEN(capacity, item_size) \
+    ((capacity) + (PQ_INLINE_STORAGE_SIZE(capacity, item_size) + sizeof(pq_slot_t) - 1) / sizeof(pq_slot_t))
+
 // API de FreeRTOS
+// Como las colas de FreeRTOS, cada elemento son item_size bytes que se copian al
+// enviar y al recibir (pvItemToQueue/pvBuffer). La prioridad sale del primer campo
+// del mensaje (pq_priority_t) o del argumento de xPriorityQueueSendWithPriority.
+// xPriorityQueueCreatePtr crea en cambio una cola de punteros a mensajes de
+// pvPortMalloc (no admite préstamos).
+// Receive/ReceiveBatch bloquean a la tarea en su notificación directa, con
+// timeout exacto. Por defecto Send nunca espera lugar: con la cola llena aplica
+// la política de desborde (descartar el más antiguo, o la elegida con
+// vPriorityQueueSetOverflowPolicy); con vPriorityQueueSetBlockingSend espera
+// hasta ticksToWait.
+// SendWithHandle y Commit devuelven un handle del mensaje encolado: con él,
+// Remove y Reprioritize lo retiran o lo cambian de nivel en O(1). RemoveIf
+// recorre la cola buscando por predicado (O(n)).
+// AcquireSlot/Commit y ReceiveLoan/Release son la versión sin copia para colas
+// por valor: el mensaje se escribe y se lee en el slot de la cola.
+// Las variantes FromISR nunca esperan y siguen la semántica de pxHigherPriorityTaskWoken
+// de xQueueSendFromISR; la ISR tiene que tener prioridad lógica menor o igual a
+// configMAX_SYSCALL_INTERRUPT_PRIORITY. SendFromISR solo admite colas por valor.
 PriorityQueueHandle_t xPriorityQueueCreate(size_t capacity, size_t item_size);
+PriorityQueueHandle_t xPriorityQueueCreatePtr(size_t capacity);
+PriorityQueueHandle_t xPriorityQueueCreateStatic(size_t capacity, size_t item_size, pq_slot_t *storage, StaticPriorityQueue_t *control_block);
 void vPriorityQueueDelete(PriorityQueueHandle_t handle);
-BaseType_t xPriorityQueueSend(PriorityQueueHandle_t handle, void * const *ppItem, TickType_t ticksToWait);
-BaseType_t xPriorityQueueReceive(PriorityQueueHandle_t handle, void **ppItem, TickType_t ticksToWait);
+void vPriorityQueueSetBlockingSend(PriorityQueueHandle_t handle, BaseType_t xBlocking);
+void vPriorityQueueSetOverflowPolicy(PriorityQueueHandle_t handle, pq_overflow_policy_t policy);
+void vPriorityQueueSetAging(PriorityQueueHandle_t handle, TickType_t xAgingTicks);
+BaseType_t xPriorityQueueSend(PriorityQueueHandle_t handle, const void *pvItemToQueue, TickType_t ticksToWait);
+BaseType_t xPriorityQueueSendWithHandle(PriorityQueueHandle_t handle, const void *pvItemToQueue, pq_handle_t *pxItemHandle, TickType_t ticksToWait);
+BaseType_t xPriorityQueueSendWithPriority(PriorityQueueHandle_t handle, const void *pvItemToQueue, pq_priority_t prio, TickType_t ticksToWait);
+BaseType_t xPriorityQueueReceive(PriorityQueueHandle_t handle, void *pvBuffer, TickType_t ticksToWait);
+BaseType_t xPriorityQueueSendFromISR(PriorityQueueHandle_t handle, const void *pvItemToQueue, BaseType_t *pxHigherPriorityTaskWoken);
+BaseType_t xPriorityQueueReceiveFromISR(PriorityQueueHandle_t handle, void *pvBuffer, BaseType_t *pxHigherPriorityTaskWoken);
+UBaseType_t xPriorityQueueSendBatch(PriorityQueueHandle_t handle, const void *pvItems, UBaseType_t count, TickType_t ticksToWait);
+UBaseType_t xPriorityQueueReceiveBatch(PriorityQueueHandle_t handle, void *pvBuffer, UBaseType_t maxItems, TickType_t ticksToWait);
+BaseType_t xPriorityQueueRemove(PriorityQueueHandle_t handle, pq_handle_t xItem, void *pvBuffer);
+UBaseType_t xPriorityQueueRemoveIf(PriorityQueueHandle_t handle, pq_match_fn_t match, void *ctx);
+BaseType_t xPriorityQueueReprioritize(PriorityQueueHandle_t handle, pq_handle_t xItem, pq_priority_t newPrio);
+BaseType_t xPriorityQueueAcquireSlot(PriorityQueueHandle_t handle, pq_priority_t prio, void **ppvSlot, TickType_t ticksToWait);
+BaseType_t xPriorityQueueCommit(PriorityQueueHandle_t handle, void *pvSlot, pq_handle_t *pxItemHandle);
+BaseType_t xPriorityQueueReceiveLoan(PriorityQueueHandle_t handle, void **ppvSlot, TickType_t ticksToWait);
+void vPriorityQueueRelease(PriorityQueueHandle_t handle, void *pvSlot);
+UBaseType_t uxPriorityQueueMessagesWaiting(PriorityQueueHandle_t handle);
+void vPriorityQueueGetStats(PriorityQueueHandle_t handle, pq_stats_t *pxStats);
 
 #endif /* INC_FREERTOS_PRIORITY_QUEUE_H_ */
@@ -10,20 +10,76 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
+// Enlace intrusivo: va embebido dentro de la estructura del usuario, así
+// encolar y desencolar no reservan memoria. Un enlace está en una sola lista a la vez.
+// Doblemente enlazado: quitar o insertar en cualquier posición es O(1).
+typedef struct ll_link {
+    struct ll_link *next;
+    struct ll_link *prev;
+} ll_link_t;
+
+typedef struct {
+    ll_link_t *head;
+    ll_link_t *tail;
+    size_t size;
+} lli_list_t;
+
+// Estructura que contiene al enlace, p. ej.:
+//   my_msg_t *msg = LL_CONTAINER_OF(lli_pop_front(&list), my_msg_t, link);
+#define LL_CONTAINER_OF(ptr, type, member) \
+    ((type*)((char*)(ptr) - offsetof(type, member)))
+
+// Nodo de la lista no intrusiva: un enlace más el puntero al dato
 typedef struct ll_node {
+    ll_link_t link;
     void *data;
-    struct ll_node *next;
 } ll_node_t;
 
+// Pool de nodos de tamaño fijo sobre un arreglo del usuario (p. ej. estático):
+// reserva y liberación O(1) por free list, sin malloc ni fragmentación.
+// No tiene locking propio: se protege junto con las listas que lo usan.
 typedef struct {
-    ll_node_t *head;
-    ll_node_t *tail;
-    size_t size;
+    ll_node_t *blocks;
+    size_t capacity;
+    ll_link_t *free_head;
+    size_t used;
+    size_t high_water;          // Máximo de nodos en uso a la vez
+    uint32_t alloc_failures;    // Reservas rechazadas por pool agotado
+} ll_pool_t;
+
+typedef struct {
+    size_t used;
+    size_t high_water;
+    uint32_t alloc_failures;
+} ll_pool_stats_t;
+
+typedef struct {
+    lli_list_t links;
+    ll_pool_t *pool;    // NULL = nodos con malloc
 } linked_list_t;
 
+// API de lista intrusiva - sin dependencias del OS ni reserva de memoria
+void lli_init(lli_list_t *list);
+bool lli_push_back(lli_list_t *list, ll_link_t *link);
+ll_link_t* lli_pop_front(lli_list_t *list);
+ll_link_t* lli_peek_front(lli_list_t *list);
+bool lli_is_empty(lli_list_t *list);
+size_t lli_size(lli_list_t *list);
+bool lli_insert_before(lli_list_t *list, ll_link_t *pos, ll_link_t *link);
+bool lli_remove(lli_list_t *list, ll_link_t *link);
+void lli_splice_back(lli_list_t *dst, lli_list_t *src);
+
+// Pool de nodos para linked_list_t
+bool ll_pool_init(ll_pool_t *pool, ll_node_t *storage, size_t count);
+void ll_pool_get_stats(ll_pool_t *pool, ll_pool_stats_t *out_stats);
+
 // API de lista enlazada - sin dependencias del OS
+// Envoltorio de la intrusiva: reserva un ll_node_t por elemento, con malloc
+// o, si se inicializa con ll_init_with_pool, desde el pool (compartible entre listas)
 void ll_init(linked_list_t *list);
+void ll_init_with_pool(linked_list_t *list, ll_pool_t *pool);
 bool ll_push_back(linked_list_t *list, void *data);
 void* ll_pop_front(linked_list_t *list);
 void* ll_peek_front(linked_list_t *list);
@@ -31,4 +87,11 @@ bool ll_is_empty(linked_list_t *list);
 size_t ll_size(linked_list_t *list);
 void ll_clear(linked_list_t *list, void (*free_fn)(void*));
 
+// Acceso a los nodos, para quitar o insertar en O(1) en cualquier posición
+ll_node_t* ll_first(linked_list_t *list);
+ll_node_t* ll_next(ll_node_t *node);
+ll_node_t* ll_insert_before(linked_list_t *list, ll_node_t *pos, void *data);
+void* ll_remove(linked_list_t *list, ll_node_t *node);
+bool ll_splice_back(linked_list_t *dst, linked_list_t *src);
+
 #endif /* INC_LINKED_LIST_H_ */
@@ -8,37 +8,175 @@
 #ifndef INC_PRIORITY_QUEUE_CORE_H_
 #define INC_PRIORITY_QUEUE_CORE_H_
 
-#include "linked_list.h"
+#include <stddef.h>
+#include <stdbool.h>
 #include <stdint.h>
 
+// Cantidad de niveles de prioridad, elegida en tiempo de compilación (-D).
+// Cada nivel ocupa un bit del bitmap de ocupación, por eso el máximo es 32.
+#ifndef PQ_CONFIG_NUM_LEVELS
+#define PQ_CONFIG_NUM_LEVELS    3
+#endif
+
+#if (PQ_CONFIG_NUM_LEVELS < 3) || (PQ_CONFIG_NUM_LEVELS > 32)
+#error "PQ_CONFIG_NUM_LEVELS debe estar entre 3 y 32"
+#endif
+
+// En 1, los usuarios del core (p. ej. el wrapper de FreeRTOS) verifican
+// pqc_check_invariants después de cada operación que modifica la cola.
+// Es O(n): solo para depuración.
+#ifndef PQ_CONFIG_CHECK_INVARIANTS
+#define PQ_CONFIG_CHECK_INVARIANTS  0
+#endif
+
+// El nivel 0 es el más urgente. Con más de 3 niveles los intermedios se usan
+// casteando el número de nivel; los nombres quedan repartidos en el rango.
 typedef enum {
     PQ_PRIO_HIGH = 0,	// Pulso
-    PQ_PRIO_MED  = 1,	// Corto
-    PQ_PRIO_LOW  = 2,	// Largo
-    PQ_PRIO__N   = 3
+    PQ_PRIO_MED  = (PQ_CONFIG_NUM_LEVELS - 1) / 2,	// Corto
+    PQ_PRIO_LOW  = PQ_CONFIG_NUM_LEVELS - 1,	// Largo
+    PQ_PRIO__N   = PQ_CONFIG_NUM_LEVELS
 } pq_priority_t;
 
 typedef struct {
     pq_priority_t prio;
-    uint32_t seq;
+    uint32_t seq;       // Orden de llegada; da la vuelta, comparar con aritmética de serie
+    uint32_t deadline;  // Vencimiento absoluto (unidades del reloj), solo en modo EDF
+    uint32_t expiry;    // Instante (unidades del reloj) a partir del cual se descarta; 0 = no vence
     void *payload;
     void (*free_cb)(void*);
 } pq_item_t;
 
+// Criterio de orden de la cola
+typedef enum {
+    PQ_MODE_LEVELS = 0,     // Niveles fijos, FIFO dentro de cada nivel (por defecto)
+    PQ_MODE_EDF,            // Earliest deadline first: sale el deadline más cercano
+    PQ_MODE__N
+} pq_mode_t;
+
+// Qué hacer cuando se hace push con la cola llena
+typedef enum {
+    PQ_OVERFLOW_DROP_OLDEST = 0,    // Descarta el más antiguo de toda la cola (por defecto)
+    PQ_OVERFLOW_DROP_NEWEST,        // Descarta el elemento entrante
+    PQ_OVERFLOW_DROP_LOWEST,        // Descarta el más antiguo del nivel menos urgente
+    PQ_OVERFLOW_REJECT,             // No encola: pqc_push devuelve false
+    PQ_OVERFLOW__N
+} pq_overflow_policy_t;
+
+// Contadores de la cola. Todo elemento aceptado por push termina exactamente
+// una vez en pop/remove (popped), descartado (discarded) o sigue encolado:
+// pushed == popped + discarded + pqc_size (módulo 2^32).
+typedef struct {
+    uint32_t pushed;                            // Push aceptados (el payload pasó a la cola)
+    uint32_t popped;                            // Entregados al llamador por pop/remove
+    uint32_t discarded;                         // Descartados por el core (free_cb si lo tienen)
+    uint32_t overflow_drops[PQ_OVERFLOW__N];    // Elementos descartados/rechazados por cada política
+    uint32_t aging_promotions;                  // Ascensos de nivel por envejecimiento
+    uint32_t expired_drops;                     // Elementos descartados por vencidos
+} pq_stats_t;
+
+// Referencia a un elemento encolado, devuelta por pqc_push_ex. Combina el
+// índice del slot con su generación, así una referencia vieja (elemento ya
+// sacado o slot reutilizado) se detecta y se rechaza. La generación es de 32
+// bits: un handle vencido recién podría volver a coincidir después de 2^31
+// reusos del mismo slot.
+typedef uint64_t pq_handle_t;
+
+#define PQ_HANDLE_INVALID   ((pq_handle_t)UINT64_MAX)
+
+// Predicado para buscar/quitar elementos (p. ej. por id del mensaje)
+typedef bool (*pq_match_fn_t)(const pq_item_t *item, void *ctx);
+
+// Fuente de tiempo opcional (p. ej. xTaskGetTickCount). Sin ella, el tiempo
+// del core se mide en cantidad de pops.
+typedef uint32_t (*pq_clock_fn_t)(void);
+
+// Índice de slot dentro del almacenamiento de la cola
+typedef uint16_t pq_index_t;
+
+#define PQ_INDEX_NONE       ((pq_index_t)UINT16_MAX)
+#define PQ_CAPACITY_MAX     ((size_t)PQ_INDEX_NONE)
+
+// Payload por valor: cada slot guarda su copia alineada a puntero.
+// PQ_INLINE_STORAGE_SIZE da los bytes que necesita el buffer de pqc_set_inline_payload.
+#define PQ_PAYLOAD_STRIDE(payload_size) \
+    (((payload_size) + sizeof(void*) - 1) & ~(sizeof(void*) - 1))
+#define PQ_INLINE_STORAGE_SIZE(capacity, payload_size) \
+    ((capacity) * PQ_PAYLOAD_STRIDE(payload_size))
+
+// Slot de almacenamiento: el elemento más los enlaces por índice.
+// Un slot ocupado está encadenado en la cola de su nivel y, además, en la lista
+// global por antigüedad (todos los niveles); uno libre, en la free list. Uno
+// prestado (pqc_loan_*) no está en ninguna: lo tiene el usuario.
+typedef struct {
+    pq_item_t item;
+    uint32_t enqueued_at;   // Instante en que entró a su nivel actual
+    uint32_t gen;           // Generación del slot: impar = ocupado
+    pq_index_t next;
+    pq_index_t prev;
+    pq_index_t age_prev;
+    pq_index_t age_next;
+    pq_index_t heap;        // Columna del heap EDF: slot que ocupa la posición i del heap
+    pq_index_t heap_pos;    // Posición de este slot dentro del heap EDF
+} pq_slot_t;
+
+typedef struct {
+    pq_index_t head;
+    pq_index_t tail;
+} pq_level_t;
+
 typedef struct {
-    linked_list_t queues[PQ_PRIO__N];
+    pq_slot_t *slots;
+    pq_level_t queues[PQ_PRIO__N];
+    uint32_t ready_bitmap;  // Bit (31 - nivel) en 1 si el nivel tiene elementos
+    pq_index_t free_head;
+    pq_index_t age_head;    // Elemento más antiguo de toda la cola
+    pq_index_t age_tail;    // Elemento más reciente
     size_t total_size;
+    size_t loaned;          // Slots prestados: ni libres ni encolados
     size_t capacity;
     uint32_t seq_counter;
+    pq_mode_t mode;
+    pq_overflow_policy_t overflow_policy;
+    pq_clock_fn_t clock;
+    uint32_t pop_count;
+    uint32_t aging_threshold;   // 0 = envejecimiento deshabilitado
+    int aging_cursor;           // Último nivel revisado por el envejecimiento
+    pq_stats_t stats;
+    uint8_t *payload_storage;   // Payloads por valor (NULL = se guardan punteros)
+    size_t payload_size;
+    bool owns_storage;
+    bool owns_payload_storage;
 } priority_queue_core_t;
 
 // API baremetal - sin dependencias del OS
 bool pqc_init(priority_queue_core_t *pq, size_t capacity);
+bool pqc_init_static(priority_queue_core_t *pq, pq_slot_t *storage, size_t capacity);
+bool pqc_set_inline_payload(priority_queue_core_t *pq, void *storage, size_t payload_size);
+bool pqc_set_mode(priority_queue_core_t *pq, pq_mode_t mode);
+bool pqc_set_overflow_policy(priority_queue_core_t *pq, pq_overflow_policy_t policy);
+void pqc_set_clock(priority_queue_core_t *pq, pq_clock_fn_t clock);
+bool pqc_set_aging(priority_queue_core_t *pq, uint32_t threshold);
 bool pqc_push(priority_queue_core_t *pq, pq_item_t *item);
+bool pqc_push_ex(priority_queue_core_t *pq, pq_item_t *item, pq_handle_t *out_handle);
+bool pqc_push_evict(priority_queue_core_t *pq, pq_item_t *item, pq_handle_t *out_handle, pq_item_t *out_evicted);
 bool pqc_pop(priority_queue_core_t *pq, pq_item_t *out_item);
+size_t pqc_push_n(priority_queue_core_t *pq, pq_item_t *items, size_t count);
+size_t pqc_pop_n(priority_queue_core_t *pq, pq_item_t *out_items, size_t max_items);
+bool pqc_remove(priority_queue_core_t *pq, pq_handle_t handle, pq_item_t *out_item);
+size_t pqc_remove_if(priority_queue_core_t *pq, pq_match_fn_t match, void *ctx);
+pq_handle_t pqc_find(priority_queue_core_t *pq, pq_match_fn_t match, void *ctx);
+bool pqc_reprioritize(priority_queue_core_t *pq, pq_handle_t handle, pq_priority_t new_prio);
+size_t pqc_purge_expired(priority_queue_core_t *pq);
+bool pqc_loan_acquire(priority_queue_core_t *pq, pq_item_t *item, void **out_payload);
+bool pqc_loan_commit(priority_queue_core_t *pq, void *payload, pq_handle_t *out_handle);
+bool pqc_pop_loan(priority_queue_core_t *pq, pq_item_t *out_item);
+bool pqc_loan_release(priority_queue_core_t *pq, void *payload);
 bool pqc_is_empty(priority_queue_core_t *pq);
 bool pqc_is_full(priority_queue_core_t *pq);
 size_t pqc_size(priority_queue_core_t *pq);
+void pqc_get_stats(priority_queue_core_t *pq, pq_stats_t *out_stats);
+bool pqc_check_invariants(priority_queue_core_t *pq);
 void pqc_destroy(priority_queue_core_t *pq);
 
 #endif /* INC_PRIORITY_QUEUE_CORE_H_ */
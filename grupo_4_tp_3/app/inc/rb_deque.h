@@ -0,0 +1,39 @@
+#ifndef INC_RB_DEQUE_H_
+#define INC_RB_DEQUE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Deque sobre un buffer circular contiguo de elementos de tamaño fijo, copiados
+// por valor. La capacidad es potencia de 2: los índices corren libres y se
+// enmascaran al acceder, así que lleno/vacío se distinguen sin slot extra.
+typedef struct {
+    uint8_t *buffer;
+    size_t elem_size;
+    uint32_t mask;      // capacidad - 1
+    uint32_t head;      // Índice (sin enmascarar) del primer elemento
+    uint32_t tail;      // Índice (sin enmascarar) siguiente al último
+    bool owns_buffer;
+} rb_deque_t;
+
+// Bytes que necesita el buffer de rb_init_static
+#define RB_STORAGE_SIZE(capacity, elem_size)    ((capacity) * (elem_size))
+
+// API de deque circular - sin dependencias del OS
+bool rb_init(rb_deque_t *rb, size_t capacity, size_t elem_size);
+bool rb_init_static(rb_deque_t *rb, void *storage, size_t capacity, size_t elem_size);
+bool rb_push_back(rb_deque_t *rb, const void *elem);
+bool rb_push_front(rb_deque_t *rb, const void *elem);
+bool rb_pop_front(rb_deque_t *rb, void *out_elem);
+bool rb_pop_back(rb_deque_t *rb, void *out_elem);
+void* rb_peek_front(rb_deque_t *rb);
+void* rb_peek_back(rb_deque_t *rb);
+bool rb_is_empty(rb_deque_t *rb);
+bool rb_is_full(rb_deque_t *rb);
+size_t rb_size(rb_deque_t *rb);
+size_t rb_capacity(rb_deque_t *rb);
+void rb_clear(rb_deque_t *rb);
+void rb_destroy(rb_deque_t *rb);
+
+#endif /* INC_RB_DEQUE_H_ */
@@ -8,18 +8,181 @@
 
 #include "freertos_priority_queue.h"
 #include "task.h"
+#include "linked_list.h"
+#include <string.h>
+
+// Con PQ_CONFIG_CHECK_INVARIANTS en 1 se verifica el core (dentro de la sección
+// crítica) después de cada operación que lo modifica
+#if PQ_CONFIG_CHECK_INVARIANTS
+#define PQ_CHECK(handle)    configASSERT(pqc_check_invariants(&(handle)->core))
+#else
+#define PQ_CHECK(handle)
+#endif
+
+// Sincronización: el core se protege con secciones críticas cortas (todas sus
+// operaciones son O(1), salvo las que recorren la cola) y las tareas que esperan
+// elementos se bloquean en su notificación directa, anotadas en una lista de
+// espera. Un Send/Receive sin espera es una sola entrada/salida de sección crítica.
+// La notificación de la tarea se usa mientras espera: no debe usarla para otra cosa.
+// Nada se libera (vPortFree) dentro de la sección crítica.
+
+// Descartados que SendBatch junta en el stack para liberarlos fuera de la sección crítica
+#define PQ_BATCH_EVICTED_MAX    8
+
+// Tarea bloqueada esperando; vive en el stack de la propia tarea
+typedef struct {
+    ll_link_t link;
+    TaskHandle_t task;
+    UBaseType_t prio;
+    bool linked;
+} pq_waiter_t;
 
 struct freertos_pq_opaque {
     priority_queue_core_t core;
-    SemaphoreHandle_t mutex;
-    SemaphoreHandle_t items_sem;
+    lli_list_t receivers;   // Tareas esperando elementos
+    lli_list_t senders;     // Tareas esperando lugar (solo con envío bloqueante)
     size_t item_size;
+    pq_overflow_policy_t overflow_policy;   // Política elegida; con envío bloqueante el core usa REJECT
+    bool by_value;          // Copia item_size bytes (si no, guarda punteros a mensajes: xPriorityQueueCreatePtr)
+    bool is_static;         // Bloque de control del llamador: no se libera
+    bool blocking_send;     // Con la cola llena, Send espera en vez de descartar
 };
 
-PriorityQueueHandle_t xPriorityQueueCreate(size_t capacity, size_t item_size) {
-    if (item_size != sizeof(void*)) return NULL;
+// El tipo público de xPriorityQueueCreateStatic tiene que coincidir con la estructura interna
+_Static_assert(sizeof(StaticPriorityQueue_t) == sizeof(struct freertos_pq_opaque),
+               "StaticPriorityQueue_t no coincide con struct freertos_pq_opaque");
+
+// Arma el elemento del core a partir de pvItem, que apunta a item_size bytes
+// (como en xQueueSend). Por valor, el core guarda una copia del elemento; en una
+// cola de xPriorityQueueCreatePtr, el elemento es la dirección del mensaje, que se
+// libera con vPortFree si la cola lo descarta. Sin prio explícita, el mensaje
+// empieza con su pq_priority_t.
+static bool make_item(PriorityQueueHandle_t handle, const void *pvItem, const pq_priority_t *prio, pq_item_t *item) {
+    void *msg = handle->by_value ? (void*)pvItem : *(void * const *)pvItem;
+    if (!msg) return false;
+
+    memset(item, 0, sizeof(*item));	// seq se asigna automáticamente al hacer push
+    item->payload = msg;
+    item->free_cb = handle->by_value ? NULL : vPortFree;
+
+    if (prio) {
+        item->prio = *prio;
+    } else {
+        if (handle->by_value && handle->item_size < sizeof(pq_priority_t)) return false;
+        memcpy(&item->prio, msg, sizeof(item->prio));
+    }
+    return item->prio < PQ_PRIO__N;
+}
+
+// Prepara out para un pop: por valor, el core copia el elemento directo en pvBuffer
+static void prepare_out(PriorityQueueHandle_t handle, pq_item_t *out, void *pvBuffer) {
+    out->payload = handle->by_value ? pvBuffer : NULL;
+}
+
+// Completa pvBuffer después de un pop: por puntero, se entrega la dirección del mensaje
+static void deliver_out(PriorityQueueHandle_t handle, pq_item_t *out, void *pvBuffer) {
+    if (!handle->by_value) *(void**)pvBuffer = out->payload;
+}
+
+// Libera un elemento que el core entregó en lugar de liberarlo (fuera de la sección crítica)
+static void release_evicted(pq_item_t *item) {
+    if (item->free_cb && item->payload) {
+        item->free_cb(item->payload);
+    }
+}
+
+// Saca de la lista de espera a la tarea de mayor prioridad (la más antigua
+// entre iguales) y devuelve su handle, o NULL si no hay nadie esperando.
+// Se llama con la sección crítica tomada.
+static TaskHandle_t pick_waiter(lli_list_t *waiters) {
+    pq_waiter_t *best = NULL;
+
+    for (ll_link_t *link = waiters->head; link; link = link->next) {
+        pq_waiter_t *w = LL_CONTAINER_OF(link, pq_waiter_t, link);
+        if (!best || w->prio > best->prio) best = w;
+    }
+    if (!best) return NULL;
+
+    lli_remove(waiters, &best->link);
+    best->linked = false;
+    return best->task;
+}
+
+static void wake_one(lli_list_t *waiters) {
+    TaskHandle_t task = pick_waiter(waiters);
+    if (task) xTaskNotifyGive(task);
+}
+
+// Un despertar por elemento (o lugar) nuevo, mientras haya tareas esperando
+static void wake_many(lli_list_t *waiters, UBaseType_t count) {
+    for (UBaseType_t i = 0; i < count && !lli_is_empty(waiters); i++) {
+        wake_one(waiters);
+    }
+}
+
+static void wake_one_from_isr(lli_list_t *waiters, BaseType_t *pxHigherPriorityTaskWoken) {
+    TaskHandle_t task = pick_waiter(waiters);
+    if (task) vTaskNotifyGiveFromISR(task, pxHigherPriorityTaskWoken);
+}
+
+// Bloquea a la tarea actual en la lista de espera hasta que la despierten o
+// venza el timeout. Se llama con la sección crítica tomada y vuelve con ella
+// tomada. Devuelve false si el tiempo ya venció: el timeout total es exacto,
+// sin importar cuántas veces se reintente.
+static bool block_on(lli_list_t *waiters, pq_waiter_t *waiter, TimeOut_t *timeout, TickType_t *ticksToWait) {
+    if (xTaskCheckForTimeOut(timeout, ticksToWait) != pdFALSE) return false;
+
+    waiter->task = xTaskGetCurrentTaskHandle();
+    waiter->prio = uxTaskPriorityGet(NULL);
+    waiter->linked = true;
+    lli_push_back(waiters, &waiter->link);
+
+    taskEXIT_CRITICAL();
+    (void)ulTaskNotifyTake(pdTRUE, *ticksToWait);
+    taskENTER_CRITICAL();
+
+    // Venció sin que nadie la despierte: se borra de la lista
+    if (waiter->linked) {
+        lli_remove(waiters, &waiter->link);
+        waiter->linked = false;
+    }
+    return true;
+}
+
+// Reloj del core: el tiempo de la cola (envejecimiento) se mide en ticks. Se
+// llama dentro de secciones críticas y desde las variantes FromISR; en este
+// port TickType_t es atómico y xTaskGetTickCount es una sola lectura.
+static uint32_t tick_clock(void) {
+    return (uint32_t)xTaskGetTickCount();
+}
+
+// Parte común de Create/CreateStatic, con el core ya inicializado.
+// Por valor, payload_storage recibe PQ_INLINE_STORAGE_SIZE(capacity, item_size) bytes.
+static bool setup_handle(struct freertos_pq_opaque *handle, size_t item_size, bool by_value, void *payload_storage, bool is_static) {
+    handle->item_size = item_size;
+    handle->by_value = by_value;
+    handle->is_static = is_static;
+    handle->blocking_send = false;
+    handle->overflow_policy = PQ_OVERFLOW_DROP_OLDEST;
+    lli_init(&handle->receivers);
+    lli_init(&handle->senders);
+    pqc_set_clock(&handle->core, tick_clock);
+
+    return !handle->by_value || pqc_set_inline_payload(&handle->core, payload_storage, item_size);
+}
+
+// Reserva la cola en un solo bloque del heap de FreeRTOS. Por valor, las copias
+// van a continuación del bloque de control.
+static PriorityQueueHandle_t create(size_t capacity, size_t item_size, bool by_value) {
+    if (item_size == 0 || capacity == 0 || capacity > PQ_CAPACITY_MAX) return NULL;
+
+    size_t payload_bytes = 0;
+    if (by_value) {
+        if (item_size > (SIZE_MAX - sizeof(struct freertos_pq_opaque)) / capacity - sizeof(void*)) return NULL;
+        payload_bytes = PQ_INLINE_STORAGE_SIZE(capacity, item_size);
+    }
 
-    struct freertos_pq_opaque *handle = pvPortMalloc(sizeof(*handle));
+    struct freertos_pq_opaque *handle = pvPortMalloc(sizeof(*handle) + payload_bytes);
     if (!handle) return NULL;
 
     if (!pqc_init(&handle->core, capacity)) {
@@ -27,89 +190,491 @@ PriorityQueueHandle_t xPriorityQueueCreate(size_t capacity, size_t item_size) {
         return NULL;
     }
 
-    // Crear sincronización de FreeRTOS
-    handle->mutex = xSemaphoreCreateMutex();
-    if (!handle->mutex) {
+    if (!setup_handle(handle, item_size, by_value, handle + 1, false)) {
+        pqc_destroy(&handle->core);
         vPortFree(handle);
         return NULL;
     }
+    return handle;
+}
 
-    handle->items_sem = xSemaphoreCreateCounting((UBaseType_t)capacity, 0); // Contador de elementos disponibles
-    if (!handle->items_sem) {
-        vSemaphoreDelete(handle->mutex);
-        vPortFree(handle);
-        return NULL;
-    }
+// Como xQueueCreate: cada elemento son item_size bytes (cualquier tamaño, también
+// el de un puntero) que se copian al enviar y al recibir
+PriorityQueueHandle_t xPriorityQueueCreate(size_t capacity, size_t item_size) {
+    return create(capacity, item_size, true);
+}
 
-    handle->item_size = item_size;
+// Cola de punteros: cada elemento es la dirección de un mensaje de pvPortMalloc
+// (se envía &msg, se recibe en un void*), que la cola libera si lo descarta
+PriorityQueueHandle_t xPriorityQueueCreatePtr(size_t capacity) {
+    return create(capacity, sizeof(void*), false);
+}
+
+// Como xQueueCreateStatic: la cola entera (bloque de control, slots y copias de
+// los elementos) vive en memoria del llamador, p. ej. en .bss, sin tocar el heap
+// de FreeRTOS. storage tiene PRIORITY_QUEUE_STORAGE_LEN(capacity, item_size) elementos.
+PriorityQueueHandle_t xPriorityQueueCreateStatic(size_t capacity, size_t item_size, pq_slot_t *storage, StaticPriorityQueue_t *control_block) {
+    if (item_size == 0 || !storage || !control_block) return NULL;
+
+    struct freertos_pq_opaque *handle = (struct freertos_pq_opaque*)control_block;
+
+    if (!pqc_init_static(&handle->core, storage, capacity)) return NULL;
+
+    // Las copias de los elementos van después de los slots
+    if (!setup_handle(handle, item_size, true, storage + capacity, true)) return NULL;
     return handle;
 }
 
+// Como vQueueDelete: nadie puede estar usando la cola (ni bloqueado en ella,
+// ni con slots prestados)
 void vPriorityQueueDelete(PriorityQueueHandle_t handle) {
     if (!handle) return;
 
-    xSemaphoreTake(handle->mutex, portMAX_DELAY);
     pqc_destroy(&handle->core);
-    xSemaphoreGive(handle->mutex);
+    if (!handle->is_static) vPortFree(handle);
+}
 
-    vSemaphoreDelete(handle->items_sem);
-    vSemaphoreDelete(handle->mutex);
-    vPortFree(handle);
+// Envío bloqueante: con la cola llena, Send/SendBatch esperan hasta ticksToWait a
+// que se libere lugar en vez de aplicar la política de desborde. Las tareas que
+// esperan se despiertan de a una por cada elemento que sale, la de mayor prioridad
+// primero. Al desactivarlo vuelve la política elegida con vPriorityQueueSetOverflowPolicy.
+// Las variantes FromISR nunca esperan: con envío bloqueante y la cola llena fallan.
+void vPriorityQueueSetBlockingSend(PriorityQueueHandle_t handle, BaseType_t xBlocking) {
+    if (!handle) return;
+
+    taskENTER_CRITICAL();
+    handle->blocking_send = (xBlocking != pdFALSE);
+    pqc_set_overflow_policy(&handle->core, handle->blocking_send ? PQ_OVERFLOW_REJECT : handle->overflow_policy);
+    taskEXIT_CRITICAL();
 }
 
-BaseType_t xPriorityQueueSend(PriorityQueueHandle_t handle, void * const *ppItem, TickType_t ticksToWait) {
-    if (!handle || !ppItem || !*ppItem) return errQUEUE_FULL;
+// Qué hace Send con la cola llena, sin envío bloqueante (por defecto
+// PQ_OVERFLOW_DROP_OLDEST). Con PQ_OVERFLOW_DROP_LOWEST, por ejemplo, una
+// sobrecarga descarta primero los mensajes menos urgentes. Con envío bloqueante
+// activo se guarda y se aplica al desactivarlo.
+void vPriorityQueueSetOverflowPolicy(PriorityQueueHandle_t handle, pq_overflow_policy_t policy) {
+    if (!handle || policy >= PQ_OVERFLOW__N) return;
 
+    taskENTER_CRITICAL();
+    handle->overflow_policy = policy;
+    if (!handle->blocking_send) pqc_set_overflow_policy(&handle->core, policy);
+    taskEXIT_CRITICAL();
+}
 
-    typedef struct { pq_priority_t prio; } msg_header_t;
-    msg_header_t *hdr = (msg_header_t*)(*ppItem);
+// Envejecimiento contra la inanición: un mensaje que espera xAgingTicks en su
+// nivel sube uno, así los de menor prioridad salen aunque no dejen de llegar
+// urgentes. Se revisa en cada Receive, en O(1) amortizado. 0 lo deshabilita
+// (por defecto).
+void vPriorityQueueSetAging(PriorityQueueHandle_t handle, TickType_t xAgingTicks) {
+    if (!handle) return;
 
+    taskENTER_CRITICAL();
+    pqc_set_aging(&handle->core, (uint32_t)xAgingTicks);
+    taskEXIT_CRITICAL();
+}
 
-    pq_item_t item = {
-        .prio = hdr->prio,
-        .seq = 0,	// se asigna automáticamente al hacer push
-        .payload = *ppItem,
-        .free_cb = vPortFree
-    };
+// Con envío bloqueante se espera mientras la cola esté llena. Sin él, la política
+// de desborde hace lugar, salvo que todos los slots estén prestados: no hay nada
+// que descartar y hay que esperar un vPriorityQueueRelease.
+static bool must_wait_for_space(PriorityQueueHandle_t handle) {
+    return pqc_is_full(&handle->core) && (handle->blocking_send || pqc_is_empty(&handle->core));
+}
 
-    if (xSemaphoreTake(handle->mutex, ticksToWait) != pdPASS) {
-        return errQUEUE_FULL;
+// Envía un elemento ya armado, esperando lugar si hace falta
+static BaseType_t send_item(PriorityQueueHandle_t handle, pq_item_t *item, pq_handle_t *pxItemHandle, TimeOut_t *timeout, TickType_t *ticksToWait) {
+    pq_waiter_t waiter;
+    pq_item_t evicted;
+    bool success;
+
+    taskENTER_CRITICAL();
+    // Se espera antes de intentar el push: así un envío que espera cuenta a lo sumo
+    // un rechazo en las estadísticas (si vence el timeout), no uno por reintento
+    while (must_wait_for_space(handle) && block_on(&handle->senders, &waiter, timeout, ticksToWait)) {
     }
+    success = pqc_push_evict(&handle->core, item, pxItemHandle, &evicted);
+    PQ_CHECK(handle);
+    if (success) wake_one(&handle->receivers);
+    taskEXIT_CRITICAL();
+
+    release_evicted(&evicted);
+
+    return success ? pdPASS : errQUEUE_FULL;
+}
+
+BaseType_t xPriorityQueueSend(PriorityQueueHandle_t handle, const void *pvItemToQueue, TickType_t ticksToWait) {
+    if (!handle || !pvItemToQueue) return errQUEUE_FULL;
+
+    TimeOut_t timeout;
+    pq_item_t item;
+    if (!make_item(handle, pvItemToQueue, NULL, &item)) return errQUEUE_FULL;
+
+    vTaskSetTimeOutState(&timeout);
+    return send_item(handle, &item, NULL, &timeout, &ticksToWait);
+}
+
+// Igual que xPriorityQueueSend, y además devuelve en pxItemHandle el handle del
+// mensaje para quitarlo o repriorizarlo en O(1) con xPriorityQueueRemove y
+// xPriorityQueueReprioritize. PQ_HANDLE_INVALID si no quedó encolado (falló, o
+// la política de desborde descartó al entrante).
+BaseType_t xPriorityQueueSendWithHandle(PriorityQueueHandle_t handle, const void *pvItemToQueue, pq_handle_t *pxItemHandle, TickType_t ticksToWait) {
+    if (pxItemHandle) *pxItemHandle = PQ_HANDLE_INVALID;
+    if (!handle || !pvItemToQueue) return errQUEUE_FULL;
+
+    TimeOut_t timeout;
+    pq_item_t item;
+    if (!make_item(handle, pvItemToQueue, NULL, &item)) return errQUEUE_FULL;
+
+    vTaskSetTimeOutState(&timeout);
+    return send_item(handle, &item, pxItemHandle, &timeout, &ticksToWait);
+}
+
+// Igual que xPriorityQueueSend, con la prioridad como argumento: el mensaje no
+// necesita empezar con un pq_priority_t
+BaseType_t xPriorityQueueSendWithPriority(PriorityQueueHandle_t handle, const void *pvItemToQueue, pq_priority_t prio, TickType_t ticksToWait) {
+    if (!handle || !pvItemToQueue) return errQUEUE_FULL;
+
+    TimeOut_t timeout;
+    pq_item_t item;
+    if (!make_item(handle, pvItemToQueue, &prio, &item)) return errQUEUE_FULL;
+
+    vTaskSetTimeOutState(&timeout);
+    return send_item(handle, &item, NULL, &timeout, &ticksToWait);
+}
+
+BaseType_t xPriorityQueueReceive(PriorityQueueHandle_t handle, void *pvBuffer, TickType_t ticksToWait) {
+    if (!handle || !pvBuffer) return errQUEUE_EMPTY;
+
+    TimeOut_t timeout;
+    pq_waiter_t waiter;
+    pq_item_t item;
+    bool success;
+
+    vTaskSetTimeOutState(&timeout);
+    prepare_out(handle, &item, pvBuffer);
+
+    // Se reintenta después de cada despertar: otra tarea pudo ganar el elemento
+    taskENTER_CRITICAL();
+    do {
+        success = pqc_pop(&handle->core, &item);
+    } while (!success && block_on(&handle->receivers, &waiter, &timeout, &ticksToWait));
+    PQ_CHECK(handle);
+    if (success) wake_one(&handle->senders);
+    taskEXIT_CRITICAL();
 
+    if (success) {
+        deliver_out(handle, &item, pvBuffer);
+        return pdPASS;
+    }
+
+    return errQUEUE_EMPTY;
+}
+
+// Como xQueueSendFromISR, solo para colas por valor: con la cola llena aplica la
+// política de desborde, igual que Send (el descartado es una copia, no hay nada
+// que liberar); con envío bloqueante devuelve errQUEUE_FULL. En una cola de
+// xPriorityQueueCreatePtr falla siempre: el consumidor libera con vPortFree lo
+// que recibe, y una ISR no puede reservar con pvPortMalloc.
+BaseType_t xPriorityQueueSendFromISR(PriorityQueueHandle_t handle, const void *pvItemToQueue, BaseType_t *pxHigherPriorityTaskWoken) {
+    if (!handle || !pvItemToQueue || !handle->by_value) return errQUEUE_FULL;
+
+    pq_item_t item;
+    if (!make_item(handle, pvItemToQueue, NULL, &item)) return errQUEUE_FULL;
+
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
     bool success = pqc_push(&handle->core, &item);
-    xSemaphoreGive(handle->mutex);
+    PQ_CHECK(handle);
+    if (success) wake_one_from_isr(&handle->receivers, pxHigherPriorityTaskWoken);
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    return success ? pdPASS : errQUEUE_FULL;
+}
+
+// Como xQueueReceiveFromISR: nunca espera; con la cola vacía devuelve errQUEUE_EMPTY
+BaseType_t xPriorityQueueReceiveFromISR(PriorityQueueHandle_t handle, void *pvBuffer, BaseType_t *pxHigherPriorityTaskWoken) {
+    if (!handle || !pvBuffer) return errQUEUE_EMPTY;
+
+    pq_item_t item;
+    prepare_out(handle, &item, pvBuffer);
+
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+    bool success = pqc_pop(&handle->core, &item);
+    PQ_CHECK(handle);
+    if (success) wake_one_from_isr(&handle->senders, pxHigherPriorityTaskWoken);
+    taskEXIT_CRITICAL_FROM_ISR(saved);
 
     if (success) {
-        xSemaphoreGive(handle->items_sem);
+        deliver_out(handle, &item, pvBuffer);
         return pdPASS;
     }
 
-    return errQUEUE_FULL;
+    return errQUEUE_EMPTY;
 }
 
-BaseType_t xPriorityQueueReceive(PriorityQueueHandle_t handle, void **ppItem, TickType_t ticksToWait) {
-    if (!handle || !ppItem) return errQUEUE_EMPTY;
+// pvItems es un arreglo de count elementos de item_size bytes. Por puntero, el
+// lote termina en el primer NULL.
+UBaseType_t xPriorityQueueSendBatch(PriorityQueueHandle_t handle, const void *pvItems, UBaseType_t count, TickType_t ticksToWait) {
+    if (!handle || !pvItems || count == 0) return 0;
+
+    TimeOut_t timeout;
+    pq_waiter_t waiter;
+    const uint8_t *next = pvItems;
+    UBaseType_t sent = 0;
+    bool stop = false;
+
+    // Con envío bloqueante, ticksToWait es el total para todo el lote
+    vTaskSetTimeOutState(&timeout);
+
+    // El lote entra en una sola sección crítica. Se corta en tramos solo si hay
+    // que esperar lugar o si se llena el arreglo de descartados, que se liberan afuera.
+    while (!stop && sent < count) {
+        pq_item_t evicted[PQ_BATCH_EVICTED_MAX];
+        size_t n_evicted = 0;
+        UBaseType_t pushed = 0;
+
+        taskENTER_CRITICAL();
+        while (must_wait_for_space(handle) && block_on(&handle->senders, &waiter, &timeout, &ticksToWait)) {
+        }
+        while (sent < count && n_evicted < PQ_BATCH_EVICTED_MAX) {
+            // Sin lugar: se cierra el tramo y se espera al principio del siguiente
+            if (pushed > 0 && must_wait_for_space(handle)) break;
 
-    // Esperar elemento disponible
-    if (xSemaphoreTake(handle->items_sem, ticksToWait) != pdPASS) {
-        return errQUEUE_EMPTY;
+            pq_item_t item;
+            if (!make_item(handle, next, NULL, &item) ||
+                !pqc_push_evict(&handle->core, &item, NULL, &evicted[n_evicted])) {
+                stop = true;
+                break;
+            }
+            if (evicted[n_evicted].payload) n_evicted++;
+
+            next += handle->item_size;
+            sent++;
+            pushed++;
+        }
+        PQ_CHECK(handle);
+
+        wake_many(&handle->receivers, pushed);
+        taskEXIT_CRITICAL();
+
+        for (size_t i = 0; i < n_evicted; i++) {
+            release_evicted(&evicted[i]);
+        }
     }
 
-    // Tomar mutex con el mismo timeout para consistencia
-    if (xSemaphoreTake(handle->mutex, ticksToWait) != pdPASS) {
+    return sent;
+}
+
+// pvBuffer tiene lugar para maxItems elementos de item_size bytes
+UBaseType_t xPriorityQueueReceiveBatch(PriorityQueueHandle_t handle, void *pvBuffer, UBaseType_t maxItems, TickType_t ticksToWait) {
+    if (!handle || !pvBuffer || maxItems == 0) return 0;
 
-        xSemaphoreGive(handle->items_sem);
-        return errQUEUE_EMPTY;
+    TimeOut_t timeout;
+    pq_waiter_t waiter;
+    pq_item_t item;
+    uint8_t *next = pvBuffer;
+    UBaseType_t received = 0;
+
+    vTaskSetTimeOutState(&timeout);
+
+    // Solo se espera por el primer elemento; el resto del lote se toma en la
+    // misma sección crítica
+    taskENTER_CRITICAL();
+    while (pqc_is_empty(&handle->core) && block_on(&handle->receivers, &waiter, &timeout, &ticksToWait)) {
     }
+    while (received < maxItems) {
+        prepare_out(handle, &item, next);
+        if (!pqc_pop(&handle->core, &item)) break;
+
+        deliver_out(handle, &item, next);
+        next += handle->item_size;
+        received++;
+        wake_one(&handle->senders);
+    }
+    PQ_CHECK(handle);
+    taskEXIT_CRITICAL();
+
+    return received;
+}
+
+// Quita en O(1) el mensaje de xItem (handle de xPriorityQueueSendWithHandle o
+// xPriorityQueueCommit). Con pvBuffer se entrega como en Receive; sin él se
+// descarta (por puntero, con vPortFree fuera de la sección crítica).
+BaseType_t xPriorityQueueRemove(PriorityQueueHandle_t handle, pq_handle_t xItem, void *pvBuffer) {
+    if (!handle) return pdFAIL;
 
     pq_item_t item;
-    bool success = pqc_pop(&handle->core, &item);
-    xSemaphoreGive(handle->mutex);
+    bool take = pvBuffer || !handle->by_value;
+
+    prepare_out(handle, &item, pvBuffer);
+
+    taskENTER_CRITICAL();
+    bool success = pqc_remove(&handle->core, xItem, take ? &item : NULL);
+    PQ_CHECK(handle);
+    if (success) wake_one(&handle->senders);
+    taskEXIT_CRITICAL();
+
+    if (!success) return pdFAIL;
 
+    if (pvBuffer) {
+        deliver_out(handle, &item, pvBuffer);
+    } else if (!handle->by_value) {
+        release_evicted(&item);
+    }
+    return pdPASS;
+}
+
+// Retira (y libera) los mensajes pendientes que cumplen el predicado, p. ej. un
+// job de LED identificado por su id. Devuelve cuántos se quitaron.
+UBaseType_t xPriorityQueueRemoveIf(PriorityQueueHandle_t handle, pq_match_fn_t match, void *ctx) {
+    if (!handle || !match) return 0;
+
+    UBaseType_t removed = 0;
+    pq_item_t item;
+
+    // Por valor no hay nada que liberar: una sola pasada del core, O(n)
+    if (handle->by_value) {
+        taskENTER_CRITICAL();
+        removed = (UBaseType_t)pqc_remove_if(&handle->core, match, ctx);
+        PQ_CHECK(handle);
+        wake_many(&handle->senders, removed);
+        taskEXIT_CRITICAL();
+
+        return removed;
+    }
+
+    // Por puntero, de a uno por sección crítica, para liberar cada mensaje afuera
+    for (;;) {
+        taskENTER_CRITICAL();
+        pq_handle_t found = pqc_find(&handle->core, match, ctx);
+        bool success = pqc_remove(&handle->core, found, &item);
+        PQ_CHECK(handle);
+        if (success) wake_one(&handle->senders);
+        taskEXIT_CRITICAL();
+
+        if (!success) break;
+
+        release_evicted(&item);
+        removed++;
+    }
+
+    return removed;
+}
+
+// Cambia en O(1) la prioridad del mensaje de xItem
+BaseType_t xPriorityQueueReprioritize(PriorityQueueHandle_t handle, pq_handle_t xItem, pq_priority_t newPrio) {
+    if (!handle) return pdFAIL;
+
+    taskENTER_CRITICAL();
+    bool success = pqc_reprioritize(&handle->core, xItem, newPrio);
+    PQ_CHECK(handle);
+    taskEXIT_CRITICAL();
+
+    return success ? pdPASS : pdFAIL;
+}
+
+// Préstamos (solo colas por valor): el mensaje se arma y se consume directamente
+// en el slot de la cola, sin memcpy ni memoria dinámica. Para Acquire vale la
+// misma espera que para Send. El slot prestado cuenta como ocupado hasta Commit
+// o Release; Release también sirve para devolver un slot que no se va a enviar.
+BaseType_t xPriorityQueueAcquireSlot(PriorityQueueHandle_t handle, pq_priority_t prio, void **ppvSlot, TickType_t ticksToWait) {
+    if (ppvSlot) *ppvSlot = NULL;
+    if (!handle || !ppvSlot || !handle->by_value) return errQUEUE_FULL;
+
+    TimeOut_t timeout;
+    pq_waiter_t waiter;
+    pq_item_t item = { .prio = prio };
+    bool success;
+
+    vTaskSetTimeOutState(&timeout);
+
+    taskENTER_CRITICAL();
+    while (must_wait_for_space(handle) && block_on(&handle->senders, &waiter, &timeout, &ticksToWait)) {
+    }
+    success = pqc_loan_acquire(&handle->core, &item, ppvSlot);
+    PQ_CHECK(handle);
+    taskEXIT_CRITICAL();
+
+    return success ? pdPASS : errQUEUE_FULL;
+}
+
+// Encola el slot de xPriorityQueueAcquireSlot, con la prioridad pedida al reservarlo.
+// pxItemHandle (opcional) recibe el handle del mensaje, como en SendWithHandle.
+// Sin envío bloqueante, un emisor que esperaba porque todos los slots estaban
+// prestados ya puede hacer lugar descartando: se lo despierta.
+BaseType_t xPriorityQueueCommit(PriorityQueueHandle_t handle, void *pvSlot, pq_handle_t *pxItemHandle) {
+    if (pxItemHandle) *pxItemHandle = PQ_HANDLE_INVALID;
+    if (!handle || !pvSlot) return pdFAIL;
+
+    taskENTER_CRITICAL();
+    bool success = pqc_loan_commit(&handle->core, pvSlot, pxItemHandle);
+    PQ_CHECK(handle);
     if (success) {
-        *ppItem = item.payload;
+        wake_one(&handle->receivers);
+        if (!handle->blocking_send) wake_one(&handle->senders);
+    }
+    taskEXIT_CRITICAL();
+
+    return success ? pdPASS : pdFAIL;
+}
+
+// Igual que xPriorityQueueReceive, pero entrega un puntero al mensaje dentro de
+// la cola. Hay que devolverlo con vPriorityQueueRelease al terminar de usarlo.
+BaseType_t xPriorityQueueReceiveLoan(PriorityQueueHandle_t handle, void **ppvSlot, TickType_t ticksToWait) {
+    if (ppvSlot) *ppvSlot = NULL;
+    if (!handle || !ppvSlot || !handle->by_value) return errQUEUE_EMPTY;
+
+    TimeOut_t timeout;
+    pq_waiter_t waiter;
+    pq_item_t item;
+    bool success;
+
+    vTaskSetTimeOutState(&timeout);
+
+    // El slot sigue ocupado mientras dure el préstamo: no se despierta a ningún emisor
+    taskENTER_CRITICAL();
+    do {
+        success = pqc_pop_loan(&handle->core, &item);
+    } while (!success && block_on(&handle->receivers, &waiter, &timeout, &ticksToWait));
+    PQ_CHECK(handle);
+    taskEXIT_CRITICAL();
+
+    if (success) {
+        *ppvSlot = item.payload;
         return pdPASS;
     }
 
     return errQUEUE_EMPTY;
 }
+
+void vPriorityQueueRelease(PriorityQueueHandle_t handle, void *pvSlot) {
+    if (!handle || !pvSlot) return;
+
+    taskENTER_CRITICAL();
+    bool success = pqc_loan_release(&handle->core, pvSlot);
+    PQ_CHECK(handle);
+    if (success) wake_one(&handle->senders);
+    taskEXIT_CRITICAL();
+
+    configASSERT(success);
+}
+
+// Como uxQueueMessagesWaiting. Es el tamaño del core: no hay un contador
+// aparte que se pueda desincronizar cuando la política de desborde descarta.
+UBaseType_t uxPriorityQueueMessagesWaiting(PriorityQueueHandle_t handle) {
+    if (!handle) return 0;
+
+    taskENTER_CRITICAL();
+    UBaseType_t waiting = (UBaseType_t)pqc_size(&handle->core);
+    taskEXIT_CRITICAL();
+
+    return waiting;
+}
+
+// Copia de los contadores del core, p. ej. para ver cuántos mensajes descartó
+// la política de desborde (overflow_drops) bajo sobrecarga
+void vPriorityQueueGetStats(PriorityQueueHandle_t handle, pq_stats_t *pxStats) {
+    if (!handle || !pxStats) return;
+
+    taskENTER_CRITICAL();
+    pqc_get_stats(&handle->core, pxStats);
+    taskEXIT_CRITICAL();
+}
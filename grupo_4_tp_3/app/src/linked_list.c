@@ -8,58 +8,180 @@
 #include "linked_list.h"
 #include <stdlib.h>
 
-void ll_init(linked_list_t *list) {
+void lli_init(lli_list_t *list) {
     if (!list) return;
     list->head = NULL;
     list->tail = NULL;
     list->size = 0;
 }
 
-bool ll_push_back(linked_list_t *list, void *data) {
-    if (!list || !data) return false;
+bool lli_push_back(lli_list_t *list, ll_link_t *link) {
+    return lli_insert_before(list, NULL, link);
+}
 
-    ll_node_t *node = malloc(sizeof(ll_node_t));
-    if (!node) return false;
+ll_link_t* lli_pop_front(lli_list_t *list) {
+    if (!list || !list->head) return NULL;
 
-    node->data = data;
-    node->next = NULL;
+    ll_link_t *link = list->head;
+    lli_remove(list, link);
+    return link;
+}
 
-    if (!list->head) {
-        list->head = list->tail = node;
-    } else {
-        list->tail->next = node;
-        list->tail = node;
-    }
+ll_link_t* lli_peek_front(lli_list_t *list) {
+    return list ? list->head : NULL;
+}
+
+bool lli_is_empty(lli_list_t *list) {
+    return (!list || list->size == 0);
+}
+
+size_t lli_size(lli_list_t *list) {
+    return list ? list->size : 0;
+}
+
+// Inserta link antes de pos, que tiene que estar en la lista; con pos NULL va al final
+bool lli_insert_before(lli_list_t *list, ll_link_t *pos, ll_link_t *link) {
+    if (!list || !link) return false;
+
+    ll_link_t *prev = pos ? pos->prev : list->tail;
+
+    link->next = pos;
+    link->prev = prev;
+
+    if (prev) prev->next = link;
+    else list->head = link;
+
+    if (pos) pos->prev = link;
+    else list->tail = link;
 
     list->size++;
     return true;
 }
 
-void* ll_pop_front(linked_list_t *list) {
-    if (!list || !list->head) return NULL;
+// Quita link de la lista. No se verifica que pertenezca a ella: hacerlo costaría O(n).
+bool lli_remove(lli_list_t *list, ll_link_t *link) {
+    if (!list || !link || list->size == 0) return false;
 
-    ll_node_t *node = list->head;
-    void *data = node->data;
+    if (link->prev) link->prev->next = link->next;
+    else list->head = link->next;
 
-    list->head = node->next;
-    if (!list->head) list->tail = NULL;
+    if (link->next) link->next->prev = link->prev;
+    else list->tail = link->prev;
 
-    free(node);
+    link->next = NULL;
+    link->prev = NULL;
     list->size--;
+    return true;
+}
+
+// Mueve todos los elementos de src al final de dst, en orden; src queda vacía
+void lli_splice_back(lli_list_t *dst, lli_list_t *src) {
+    if (!dst || !src || dst == src || !src->head) return;
+
+    src->head->prev = dst->tail;
+    if (dst->tail) dst->tail->next = src->head;
+    else dst->head = src->head;
+
+    dst->tail = src->tail;
+    dst->size += src->size;
+
+    lli_init(src);
+}
+
+bool ll_pool_init(ll_pool_t *pool, ll_node_t *storage, size_t count) {
+    if (!pool || !storage || count == 0) return false;
+
+    // Encadenar todos los bloques en la free list
+    for (size_t i = 0; i < count; i++) {
+        storage[i].link.next = (i + 1 < count) ? &storage[i + 1].link : NULL;
+    }
+
+    pool->blocks = storage;
+    pool->capacity = count;
+    pool->free_head = &storage[0].link;
+    pool->used = 0;
+    pool->high_water = 0;
+    pool->alloc_failures = 0;
+    return true;
+}
+
+void ll_pool_get_stats(ll_pool_t *pool, ll_pool_stats_t *out_stats) {
+    if (!pool || !out_stats) return;
+    out_stats->used = pool->used;
+    out_stats->high_water = pool->high_water;
+    out_stats->alloc_failures = pool->alloc_failures;
+}
+
+static ll_node_t *node_alloc(linked_list_t *list) {
+    ll_pool_t *pool = list->pool;
+    if (!pool) return malloc(sizeof(ll_node_t));
+
+    if (!pool->free_head) {
+        pool->alloc_failures++;
+        return NULL;
+    }
+
+    ll_link_t *link = pool->free_head;
+    pool->free_head = link->next;
+
+    pool->used++;
+    if (pool->used > pool->high_water) pool->high_water = pool->used;
+
+    return LL_CONTAINER_OF(link, ll_node_t, link);
+}
+
+static void node_free(linked_list_t *list, ll_node_t *node) {
+    ll_pool_t *pool = list->pool;
+    if (!pool) {
+        free(node);
+        return;
+    }
+
+    node->link.next = pool->free_head;
+    pool->free_head = &node->link;
+    pool->used--;
+}
+
+void ll_init(linked_list_t *list) {
+    ll_init_with_pool(list, NULL);
+}
+
+void ll_init_with_pool(linked_list_t *list, ll_pool_t *pool) {
+    if (!list) return;
+    lli_init(&list->links);
+    list->pool = pool;
+}
+
+bool ll_push_back(linked_list_t *list, void *data) {
+    return ll_insert_before(list, NULL, data) != NULL;
+}
+
+void* ll_pop_front(linked_list_t *list) {
+    if (!list) return NULL;
+
+    ll_link_t *link = lli_pop_front(&list->links);
+    if (!link) return NULL;
+
+    ll_node_t *node = LL_CONTAINER_OF(link, ll_node_t, link);
+    void *data = node->data;
+
+    node_free(list, node);
     return data;
 }
 
 void* ll_peek_front(linked_list_t *list) {
-    if (!list || !list->head) return NULL;
-    return list->head->data;
+    if (!list) return NULL;
+
+    ll_link_t *link = lli_peek_front(&list->links);
+    return link ? LL_CONTAINER_OF(link, ll_node_t, link)->data : NULL;
 }
 
 bool ll_is_empty(linked_list_t *list) {
-    return (!list || list->size == 0);
+    return (!list || lli_is_empty(&list->links));
 }
 
 size_t ll_size(linked_list_t *list) {
-    return list ? list->size : 0;
+    return list ? lli_size(&list->links) : 0;
 }
 
 void ll_clear(linked_list_t *list, void (*free_fn)(void*)) {
@@ -70,3 +192,44 @@ void ll_clear(linked_list_t *list, void (*free_fn)(void*)) {
         if (free_fn && data) free_fn(data);
     }
 }
+
+ll_node_t* ll_first(linked_list_t *list) {
+    if (!list || !list->links.head) return NULL;
+    return LL_CONTAINER_OF(list->links.head, ll_node_t, link);
+}
+
+ll_node_t* ll_next(ll_node_t *node) {
+    if (!node || !node->link.next) return NULL;
+    return LL_CONTAINER_OF(node->link.next, ll_node_t, link);
+}
+
+// Inserta data antes de pos (NULL = al final). Devuelve el nodo nuevo, que
+// sirve después para quitarlo con ll_remove.
+ll_node_t* ll_insert_before(linked_list_t *list, ll_node_t *pos, void *data) {
+    if (!list || !data) return NULL;
+
+    ll_node_t *node = node_alloc(list);
+    if (!node) return NULL;
+
+    node->data = data;
+    lli_insert_before(&list->links, pos ? &pos->link : NULL, &node->link);
+    return node;
+}
+
+// Quita un nodo de la lista en O(1) y devuelve su dato
+void* ll_remove(linked_list_t *list, ll_node_t *node) {
+    if (!list || !node || !lli_remove(&list->links, &node->link)) return NULL;
+
+    void *data = node->data;
+    node_free(list, node);
+    return data;
+}
+
+// Mueve todos los elementos de src al final de dst en O(1). Los nodos no se
+// copian, así que ambas listas tienen que reservar del mismo lugar (mismo pool o malloc).
+bool ll_splice_back(linked_list_t *dst, linked_list_t *src) {
+    if (!dst || !src || dst->pool != src->pool) return false;
+
+    lli_splice_back(&dst->links, &src->links);
+    return true;
+}
@@ -10,122 +10,950 @@
 #include <stdlib.h>
 #include <string.h>
 
+// El nivel 0 va en el bit 31: así CLZ del bitmap devuelve directamente el
+// nivel no vacío más urgente (misma idea que la selección de tareas optimizada
+// por port de FreeRTOS). En Cortex-M4 __builtin_clz compila a una instrucción CLZ.
+#define LEVEL_BIT(level)        (0x80000000UL >> (level))
+#define HIGHEST_READY(bitmap)   ((int)__builtin_clz(bitmap))
+#define LOWEST_READY(bitmap)    (31 - (int)__builtin_ctz(bitmap))
+
+// Comparación de números de serie (RFC 1982) para seq, deadlines y ticks de
+// 32 bits: 'a' es anterior a 'b' si la distancia hacia adelante es menor a 2^31.
+// Sigue siendo correcta cuando el contador da la vuelta; nunca comparar con '<'.
+static bool serial_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
 bool pqc_init(priority_queue_core_t *pq, size_t capacity) {
 
-	if (!pq || capacity == 0) return false;
+	if (!pq || capacity == 0 || capacity > PQ_CAPACITY_MAX) return false;
+
+    // Única reserva de memoria: todos los slots de una vez
+    pq_slot_t *storage = malloc(capacity * sizeof(pq_slot_t));
+    if (!storage) return false;
+
+    pqc_init_static(pq, storage, capacity);
+    pq->owns_storage = true;
+
+    return true;
+}
+
+bool pqc_init_static(priority_queue_core_t *pq, pq_slot_t *storage, size_t capacity) {
+
+    if (!pq || !storage || capacity == 0 || capacity > PQ_CAPACITY_MAX) return false;
 
     for (int i = 0; i < PQ_PRIO__N; i++) {
-        ll_init(&pq->queues[i]);
+        pq->queues[i].head = PQ_INDEX_NONE;
+        pq->queues[i].tail = PQ_INDEX_NONE;
+    }
+    pq->ready_bitmap = 0;
+
+    // Encadenar todos los slots en la free list
+    for (size_t i = 0; i < capacity; i++) {
+        storage[i].next = (i + 1 < capacity) ? (pq_index_t)(i + 1) : PQ_INDEX_NONE;
+        storage[i].gen = 0;
     }
 
+    pq->slots = storage;
+    pq->free_head = 0;
+    pq->age_head = PQ_INDEX_NONE;
+    pq->age_tail = PQ_INDEX_NONE;
     pq->total_size = 0;
+    pq->loaned = 0;
     pq->capacity = capacity;
     pq->seq_counter = 0;
+    pq->mode = PQ_MODE_LEVELS;
+    pq->overflow_policy = PQ_OVERFLOW_DROP_OLDEST;
+    pq->clock = NULL;
+    pq->pop_count = 0;
+    pq->aging_threshold = 0;
+    pq->aging_cursor = 0;
+    memset(&pq->stats, 0, sizeof(pq->stats));
+    pq->payload_storage = NULL;
+    pq->payload_size = 0;
+    pq->owns_storage = false;
+    pq->owns_payload_storage = false;
 
     return true;
 }
 
-static pq_item_t* create_item_copy(const pq_item_t *src) {
-    pq_item_t *copy = malloc(sizeof(pq_item_t));
-    if (!copy) return NULL;
-    *copy = *src;
-    return copy;
+// Payload por valor de tamaño fijo: push copia payload_size bytes desde
+// item->payload al slot y pop los copia al buffer apuntado por out_item->payload,
+// como xQueueSend/xQueueReceive. El core es dueño de las copias, así que free_cb
+// no se usa. Con storage NULL el buffer se reserva una sola vez acá.
+// Se configura justo después del init, con la cola vacía.
+bool pqc_set_inline_payload(priority_queue_core_t *pq, void *storage, size_t payload_size) {
+    if (!pq || !pq->slots || payload_size == 0 || pq->total_size != 0 || pq->payload_storage) return false;
+
+    // capacity * stride tiene que entrar en size_t (también al indexar los slots)
+    if (payload_size > SIZE_MAX / pq->capacity - sizeof(void*)) return false;
+
+    if (!storage) {
+        storage = malloc(PQ_INLINE_STORAGE_SIZE(pq->capacity, payload_size));
+        if (!storage) return false;
+        pq->owns_payload_storage = true;
+    }
+
+    pq->payload_storage = storage;
+    pq->payload_size = payload_size;
+    return true;
 }
 
-static void discard_oldest(priority_queue_core_t *pq) {
+static void *slot_payload(priority_queue_core_t *pq, pq_index_t idx) {
+    return pq->payload_storage + (size_t)idx * PQ_PAYLOAD_STRIDE(pq->payload_size);
+}
 
-    int oldest_queue = -1;
-    uint32_t min_seq = UINT32_MAX;
+// El modo solo se puede cambiar con la cola vacía
+bool pqc_set_mode(priority_queue_core_t *pq, pq_mode_t mode) {
+    if (!pq || mode >= PQ_MODE__N || pq->total_size != 0) return false;
 
-    // Buscar el elemento más antiguo en todas las colas
-    for (int i = 0; i < PQ_PRIO__N; i++) {
-    	// Se mira el primer elemento de cada cola
-        pq_item_t *item = (pq_item_t*)ll_peek_front(&pq->queues[i]);
+    pq->mode = mode;
+    return true;
+}
+
+bool pqc_set_overflow_policy(priority_queue_core_t *pq, pq_overflow_policy_t policy) {
+    if (!pq || policy >= PQ_OVERFLOW__N) return false;
+
+    pq->overflow_policy = policy;
+    return true;
+}
+
+void pqc_set_clock(priority_queue_core_t *pq, pq_clock_fn_t clock) {
+    if (pq) pq->clock = clock;
+}
+
+// Un elemento que espera 'threshold' unidades de tiempo (ticks del reloj
+// configurado o, sin reloj, pops) en su nivel sube un nivel. 0 lo deshabilita.
+bool pqc_set_aging(priority_queue_core_t *pq, uint32_t threshold) {
+    if (!pq) return false;
+
+    pq->aging_threshold = threshold;
+    return true;
+}
+
+static uint32_t now(priority_queue_core_t *pq) {
+    return pq->clock ? pq->clock() : pq->pop_count;
+}
+
+// La generación se incrementa al ocupar y al liberar el slot: impar mientras
+// está en uso, y distinta cada vez, lo que invalida los handles anteriores
+static pq_index_t slot_alloc(priority_queue_core_t *pq) {
+    pq_index_t idx = pq->free_head;
+    if (idx != PQ_INDEX_NONE) {
+        pq->free_head = pq->slots[idx].next;
+        pq->slots[idx].gen++;
+    }
+    return idx;
+}
+
+static void slot_free(priority_queue_core_t *pq, pq_index_t idx) {
+    pq->slots[idx].gen++;
+    pq->slots[idx].next = pq->free_head;
+    pq->free_head = idx;
+}
+
+static pq_handle_t slot_handle(priority_queue_core_t *pq, pq_index_t idx) {
+    return ((pq_handle_t)pq->slots[idx].gen << 16) | idx;
+}
+
+// Un slot prestado se marca enlazado a sí mismo en la lista por antigüedad:
+// uno encolado nunca puede apuntarse a sí mismo. Al encolarlo, age_push_back
+// pisa la marca.
+static void slot_mark_loaned(priority_queue_core_t *pq, pq_index_t idx) {
+    pq->slots[idx].age_prev = idx;
+    pq->slots[idx].age_next = idx;
+}
+
+static bool slot_is_loaned(priority_queue_core_t *pq, pq_index_t idx) {
+    return (pq->slots[idx].gen & 1) && pq->slots[idx].age_next == idx;
+}
+
+// Devuelve el slot de un handle válido, o PQ_INDEX_NONE si está vencido.
+// Un slot prestado no está encolado: sus handles anteriores tampoco valen.
+static pq_index_t handle_slot(priority_queue_core_t *pq, pq_handle_t handle) {
+    pq_index_t idx = (pq_index_t)(handle & 0xFFFF);
+    uint32_t gen = (uint32_t)(handle >> 16);
+
+    if (idx >= pq->capacity || !(gen & 1) || pq->slots[idx].gen != gen || slot_is_loaned(pq, idx)) {
+        return PQ_INDEX_NONE;
+    }
+    return idx;
+}
+
+static void level_push_back(priority_queue_core_t *pq, int level, pq_index_t idx) {
+    pq_level_t *q = &pq->queues[level];
+    pq_slot_t *slot = &pq->slots[idx];
+
+    slot->enqueued_at = now(pq);
+    slot->next = PQ_INDEX_NONE;
+    slot->prev = q->tail;
+
+    if (q->head == PQ_INDEX_NONE) {
+        q->head = idx;
+        pq->ready_bitmap |= LEVEL_BIT(level);
+    } else {
+        pq->slots[q->tail].next = idx;
+    }
+    q->tail = idx;
+}
+
+// Desengancha un slot de cualquier posición de su nivel en O(1)
+static void level_unlink(priority_queue_core_t *pq, int level, pq_index_t idx) {
+    pq_level_t *q = &pq->queues[level];
+    pq_slot_t *slot = &pq->slots[idx];
+
+    if (slot->prev == PQ_INDEX_NONE) {
+        q->head = slot->next;
+    } else {
+        pq->slots[slot->prev].next = slot->next;
+    }
+
+    if (slot->next == PQ_INDEX_NONE) {
+        q->tail = slot->prev;
+    } else {
+        pq->slots[slot->next].prev = slot->prev;
+    }
+
+    if (q->head == PQ_INDEX_NONE) {
+        pq->ready_bitmap &= ~LEVEL_BIT(level);
+    }
+}
+
+// Lista global por antigüedad: se agrega al final en cada push y se puede
+// desenganchar cualquier elemento en O(1), sin importar su nivel
+static void age_push_back(priority_queue_core_t *pq, pq_index_t idx) {
+    pq_slot_t *slot = &pq->slots[idx];
+
+    slot->age_prev = pq->age_tail;
+    slot->age_next = PQ_INDEX_NONE;
+
+    if (pq->age_tail == PQ_INDEX_NONE) {
+        pq->age_head = idx;
+    } else {
+        pq->slots[pq->age_tail].age_next = idx;
+    }
+    pq->age_tail = idx;
+}
+
+static void age_unlink(priority_queue_core_t *pq, pq_index_t idx) {
+    pq_slot_t *slot = &pq->slots[idx];
+
+    if (slot->age_prev == PQ_INDEX_NONE) {
+        pq->age_head = slot->age_next;
+    } else {
+        pq->slots[slot->age_prev].age_next = slot->age_next;
+    }
 
-        // Si hay elemento y es mas viejo que mi candidato actual
-        if (item && item->seq < min_seq) {
-            min_seq = item->seq;
-            oldest_queue = i;
+    if (slot->age_next == PQ_INDEX_NONE) {
+        pq->age_tail = slot->age_prev;
+    } else {
+        pq->slots[slot->age_next].age_prev = slot->age_prev;
+    }
+}
+
+// Modo EDF: heap binario de mínimos guardado en la columna 'heap' de los slots,
+// sin memoria extra. El heap contiene exactamente los total_size elementos.
+static bool edf_before(const pq_item_t *a, const pq_item_t *b) {
+    if (a->deadline != b->deadline) return serial_before(a->deadline, b->deadline);
+    return serial_before(a->seq, b->seq);     // Mismo deadline: FIFO
+}
+
+static void heap_place(priority_queue_core_t *pq, size_t pos, pq_index_t idx) {
+    pq->slots[pos].heap = idx;
+    pq->slots[idx].heap_pos = (pq_index_t)pos;
+}
+
+static void heap_sift_up(priority_queue_core_t *pq, size_t pos) {
+    pq_index_t idx = pq->slots[pos].heap;
+
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        pq_index_t parent_idx = pq->slots[parent].heap;
+
+        if (!edf_before(&pq->slots[idx].item, &pq->slots[parent_idx].item)) break;
+
+        heap_place(pq, pos, parent_idx);
+        pos = parent;
+    }
+    heap_place(pq, pos, idx);
+}
+
+static void heap_sift_down(priority_queue_core_t *pq, size_t pos, size_t size) {
+    pq_index_t idx = pq->slots[pos].heap;
+
+    for (;;) {
+        size_t child = 2 * pos + 1;
+        if (child >= size) break;
+
+        pq_index_t child_idx = pq->slots[child].heap;
+        if (child + 1 < size) {
+            pq_index_t right_idx = pq->slots[child + 1].heap;
+            if (edf_before(&pq->slots[right_idx].item, &pq->slots[child_idx].item)) {
+                child++;
+                child_idx = right_idx;
+            }
         }
+
+        if (!edf_before(&pq->slots[child_idx].item, &pq->slots[idx].item)) break;
+
+        heap_place(pq, pos, child_idx);
+        pos = child;
+    }
+    heap_place(pq, pos, idx);
+}
+
+static void heap_insert(priority_queue_core_t *pq, pq_index_t idx) {
+    heap_place(pq, pq->total_size, idx);
+    heap_sift_up(pq, pq->total_size);
+}
+
+static void heap_remove(priority_queue_core_t *pq, pq_index_t idx) {
+    size_t last = pq->total_size - 1;
+    size_t pos = pq->slots[idx].heap_pos;
+
+    if (pos == last) return;
+
+    // El último del heap ocupa el hueco y se reacomoda hacia arriba o hacia abajo
+    pq_index_t moved = pq->slots[last].heap;
+    heap_place(pq, pos, moved);
+    heap_sift_up(pq, pos);
+    heap_sift_down(pq, pq->slots[moved].heap_pos, last);
+}
+
+// Con EDF el "menos urgente" es el de deadline más lejano, que siempre es una hoja
+static pq_index_t heap_latest(priority_queue_core_t *pq) {
+    pq_index_t latest = pq->slots[pq->total_size - 1].heap;
+
+    for (size_t pos = pq->total_size / 2; pos < pq->total_size; pos++) {
+        pq_index_t idx = pq->slots[pos].heap;
+        if (edf_before(&pq->slots[latest].item, &pq->slots[idx].item)) latest = idx;
+    }
+    return latest;
+}
+
+// Punto único de entrada/salida según el modo de la cola
+static void enqueue_slot(priority_queue_core_t *pq, pq_index_t idx) {
+    if (pq->mode == PQ_MODE_EDF) {
+        heap_insert(pq, idx);
+    } else {
+        level_push_back(pq, pq->slots[idx].item.prio, idx);
+    }
+}
+
+static void dequeue_slot(priority_queue_core_t *pq, pq_index_t idx) {
+    if (pq->mode == PQ_MODE_EDF) {
+        heap_remove(pq, idx);
+    } else {
+        level_unlink(pq, pq->slots[idx].item.prio, idx);
     }
-    // Si encontré algo que descartar
-    if (oldest_queue >= 0) {
-    	// Sacar el elemento más antiguo de la cola correspondiente
-        pq_item_t *discarded = (pq_item_t*)ll_pop_front(&pq->queues[oldest_queue]);
+}
+
+static pq_index_t best_slot(priority_queue_core_t *pq) {
+    if (pq->total_size == 0) return PQ_INDEX_NONE;
+
+    if (pq->mode == PQ_MODE_EDF) {
+        return pq->slots[0].heap;
+    }
+    // El nivel no vacío más urgente sale del bitmap, sin recorrer los niveles
+    return pq->queues[HIGHEST_READY(pq->ready_bitmap)].head;
+}
+
+// free_cb se llama siempre al final, con la cola ya consistente: el callback
+// puede volver a entrar al core (push, remove, ...) sin ver estados a medias.
+// Con evicted no se llama: el elemento se le entrega al llamador para que lo libere él.
+static void release_item(priority_queue_core_t *pq, pq_item_t *item, pq_item_t *evicted) {
+    pq->stats.discarded++;
+
+    if (evicted) {
+        *evicted = *item;
+        return;
+    }
+
+	// Si tiene callback de liberación, lo llamo
+    if (item->free_cb && item->payload) {
+        item->free_cb(item->payload);
+    }
+}
+
+static void evict_slot(priority_queue_core_t *pq, pq_index_t idx, pq_item_t *evicted) {
+    pq_item_t item = pq->slots[idx].item;
+
+    dequeue_slot(pq, idx);
+    age_unlink(pq, idx);
+
+    // Devolver el slot a la free list
+    slot_free(pq, idx);
+    pq->total_size--; // Reducir el tamaño total de la cola
+
+    release_item(pq, &item, evicted);
+}
+
+static void discard_slot(priority_queue_core_t *pq, pq_index_t idx) {
+    evict_slot(pq, idx, NULL);
+}
+
+// Siguiente elemento de un recorrido por antigüedad después de descartar uno.
+// Si el free_cb del descartado quitó al siguiente (su handle ya no es válido),
+// el recorrido vuelve a empezar desde el más antiguo.
+static pq_index_t walk_resume(priority_queue_core_t *pq, pq_handle_t next) {
+    if (next == PQ_HANDLE_INVALID) return PQ_INDEX_NONE;
+
+    pq_index_t idx = handle_slot(pq, next);
+    return (idx != PQ_INDEX_NONE) ? idx : pq->age_head;
+}
+
+// Descarta el elemento entrante: cuenta como push y descarte a la vez, y el push
+// se cuenta antes, para que un free_cb reentrante vea los contadores conservados
+static void drop_incoming(priority_queue_core_t *pq, pq_item_t *item, pq_item_t *evicted) {
+    pq->stats.pushed++;
+    release_item(pq, item, evicted);
+}
+
+// Aplica la política de desborde con la cola llena.
+// Devuelve true si se liberó un slot para el elemento entrante.
+static bool apply_overflow_policy(priority_queue_core_t *pq, pq_item_t *item, pq_item_t *evicted) {
+
+    pq->stats.overflow_drops[pq->overflow_policy]++;
+
+    switch (pq->overflow_policy) {
+        case PQ_OVERFLOW_DROP_OLDEST:
+            // El más antiguo de toda la cola es la cabeza de la lista por antigüedad
+            evict_slot(pq, pq->age_head, evicted);
+            return true;
 
-        if (discarded) {
-        	// Si tiene callback de liberación, lo llamo
-            if (discarded->free_cb && discarded->payload) {
-                discarded->free_cb(discarded->payload);
+        case PQ_OVERFLOW_DROP_LOWEST: {
+            if (pq->mode == PQ_MODE_EDF) {
+                pq_index_t latest = heap_latest(pq);
+                if (!serial_before(pq->slots[latest].item.deadline, item->deadline)) {
+                    evict_slot(pq, latest, evicted);
+                    return true;
+                }
+                drop_incoming(pq, item, evicted);
+                return false;
             }
-            // Liberar el espacio del elemento descartado
-            free(discarded);
-            pq->total_size--; // Reducir el tamaño total de la cola
+
+            // El nivel ocupado menos urgente es el bit en 1 más bajo del bitmap
+            int lowest = LOWEST_READY(pq->ready_bitmap);
+            if ((int)item->prio <= lowest) {
+                evict_slot(pq, pq->queues[lowest].head, evicted);
+                return true;
+            }
+            // El entrante es menos urgente que todo lo encolado: se descarta él
+            drop_incoming(pq, item, evicted);
+            return false;
         }
+
+        case PQ_OVERFLOW_DROP_NEWEST:
+            drop_incoming(pq, item, evicted);
+            return false;
+
+        case PQ_OVERFLOW_REJECT:
+        default:
+            return false;
     }
 }
 
 bool pqc_push(priority_queue_core_t *pq, pq_item_t *item) {
-    if (!pq || !item || item->prio >= PQ_PRIO__N) return false;
+    return pqc_push_ex(pq, item, NULL);
+}
+
+// Igual que pqc_push, pero devuelve un handle para quitar o repriorizar el
+// elemento más tarde. Si la política de desborde lo descartó, el handle es
+// PQ_HANDLE_INVALID.
+bool pqc_push_ex(priority_queue_core_t *pq, pq_item_t *item, pq_handle_t *out_handle) {
+    return pqc_push_evict(pq, item, out_handle, NULL);
+}
+
+// Igual que pqc_push_ex, pero el elemento que descarte la política de desborde
+// (encolado o entrante) no se libera con free_cb: se entrega en out_evicted para
+// que el llamador lo libere fuera de su sección crítica. Sin descarte, o con
+// payload por valor (no hay nada que liberar), out_evicted->payload queda en NULL.
+bool pqc_push_evict(priority_queue_core_t *pq, pq_item_t *item, pq_handle_t *out_handle, pq_item_t *out_evicted) {
+    if (out_handle) *out_handle = PQ_HANDLE_INVALID;
+    if (out_evicted) {
+        out_evicted->payload = NULL;
+        out_evicted->free_cb = NULL;
+    }
+    if (!pq || !pq->slots || !item || item->prio >= PQ_PRIO__N) return false;
+    if (pq->payload_size && !item->payload) return false;
 
     // Asignar secuencia
     item->seq = pq->seq_counter++;
 
-    // Verificar capacidad
-    if (pq->total_size >= pq->capacity) {
-        discard_oldest(pq);
+    // Con payload por valor el llamador conserva su buffer: nunca se libera
+    pq_item_t entry = *item;
+    if (pq->payload_size) entry.free_cb = NULL;
+
+    // Verificar capacidad. Si la política descartó al entrante, el push se
+    // considera hecho; con REJECT el payload sigue siendo del llamador.
+    // Con todos los slots prestados no hay nada que descartar para hacer lugar.
+    bool stored = true;
+    if (pqc_is_full(pq)) {
+        if (pq->total_size == 0) return false;
+        stored = apply_overflow_policy(pq, &entry, out_evicted);
+        if (out_evicted && pq->payload_size) out_evicted->payload = NULL;
     }
 
-    // Crear copia y agregar a la cola correspondiente
-    pq_item_t *copy = create_item_copy(item);
-    if (!copy) return false;
+    if (!stored) return pq->overflow_policy != PQ_OVERFLOW_REJECT;
 
-    if (!ll_push_back(&pq->queues[item->prio], copy)) {
-        free(copy);
-        return false;
+    // Copiar el elemento en un slot libre y agregarlo a la cola correspondiente
+    // Sin slot solo si un free_cb reentrante ocupó el que liberó la política
+    pq_index_t idx = slot_alloc(pq);
+    if (idx == PQ_INDEX_NONE) return false;
+
+    if (pq->payload_size) {
+        entry.payload = memcpy(slot_payload(pq, idx), item->payload, pq->payload_size);
     }
 
+    pq->slots[idx].item = entry;
+    enqueue_slot(pq, idx);
+    age_push_back(pq, idx);
+
     pq->total_size++;
+    pq->stats.pushed++;
+
+    if (out_handle) *out_handle = slot_handle(pq, idx);
     return true;
 }
 
+static bool is_expired(priority_queue_core_t *pq, pq_index_t idx, uint32_t t) {
+    uint32_t expiry = pq->slots[idx].item.expiry;
+    return expiry != 0 && !serial_before(t, expiry);
+}
+
+// Saca un elemento de la cola y se lo entrega al llamador (sin free_cb)
+static void take_slot(priority_queue_core_t *pq, pq_index_t idx, pq_item_t *out_item) {
+
+    if (pq->payload_size) {
+        void *dst = memcpy(out_item->payload, slot_payload(pq, idx), pq->payload_size);
+        *out_item = pq->slots[idx].item;
+        out_item->payload = dst;
+    } else {
+        *out_item = pq->slots[idx].item;
+    }
+
+    dequeue_slot(pq, idx);
+    age_unlink(pq, idx);
+    slot_free(pq, idx);
+    pq->total_size--;
+    pq->stats.popped++;
+}
+
+// Envejecimiento: en cada pop se revisa un solo nivel (el siguiente no vacío,
+// en forma circular) y se suben los elementos de su cabeza que esperaron de más.
+// Cada elemento sube como mucho PQ_PRIO__N - 1 veces en su vida, así que el
+// costo amortizado por pop es O(1) y no hace falta recorrer toda la cola.
+static void age_step(priority_queue_core_t *pq) {
+
+    // El nivel 0 no tiene a dónde subir
+    uint32_t candidates = pq->ready_bitmap & ~LEVEL_BIT(PQ_PRIO_HIGH);
+    if (candidates == 0) return;
+
+    // Próximo nivel ocupado después del cursor; si no hay, se vuelve a empezar
+    uint32_t pending = candidates & (LEVEL_BIT(pq->aging_cursor) - 1);
+    int level = HIGHEST_READY(pending ? pending : candidates);
+    pq->aging_cursor = level;
+
+    uint32_t t = now(pq);
+    pq_index_t idx = pq->queues[level].head;
+
+    while (idx != PQ_INDEX_NONE && (t - pq->slots[idx].enqueued_at) >= pq->aging_threshold) {
+        pq_item_t *item = &pq->slots[idx].item;
+
+        level_unlink(pq, level, idx);
+        item->prio = (pq_priority_t)(level - 1);
+        level_push_back(pq, item->prio, idx);
+        pq->stats.aging_promotions++;
+
+        idx = pq->queues[level].head;
+    }
+}
+
+// Elige el próximo elemento a salir: aplica el envejecimiento y descarta los
+// vencidos que estén al frente. PQ_INDEX_NONE si no queda ninguno.
+static pq_index_t front_slot(priority_queue_core_t *pq) {
+    if (pq->total_size == 0) return PQ_INDEX_NONE;
+
+    pq->pop_count++;
+    if (pq->aging_threshold && pq->mode == PQ_MODE_LEVELS) {
+        age_step(pq);
+    }
+
+    // Los vencidos se descartan recién cuando llegan al frente (expiración perezosa)
+    uint32_t t = now(pq);
+    pq_index_t idx = best_slot(pq);
+
+    while (idx != PQ_INDEX_NONE && is_expired(pq, idx, t)) {
+        discard_slot(pq, idx);
+        pq->stats.expired_drops++;
+        idx = best_slot(pq);
+    }
+    return idx;
+}
+
 bool pqc_pop(priority_queue_core_t *pq, pq_item_t *out_item) {
-    if (!pq || !out_item) return false;
+    if (!pq || !pq->slots || !out_item) return false;
+    if (pq->payload_size && !out_item->payload) return false;
 
-    // Buscar en orden de prioridad: HIGH > MED > LOW
-    for (int i = 0; i < PQ_PRIO__N; i++) {
-        if (!ll_is_empty(&pq->queues[i])) {
-            pq_item_t *item = (pq_item_t*)ll_pop_front(&pq->queues[i]);
-            if (item) {
-                *out_item = *item;
-                free(item);
-                pq->total_size--;
-                return true;
-            }
+    pq_index_t idx = front_slot(pq);
+    if (idx == PQ_INDEX_NONE) return false;
+
+    take_slot(pq, idx, out_item);
+    return true;
+}
+
+// Versiones por lote: mismo comportamiento que llamar N veces a push/pop, pensadas
+// para que el llamador sincronice una sola vez por lote y no por elemento
+size_t pqc_push_n(priority_queue_core_t *pq, pq_item_t *items, size_t count) {
+    if (!items) return 0;
+
+    size_t pushed = 0;
+    while (pushed < count && pqc_push(pq, &items[pushed])) {
+        pushed++;
+    }
+    return pushed;
+}
+
+size_t pqc_pop_n(priority_queue_core_t *pq, pq_item_t *out_items, size_t max_items) {
+    if (!out_items) return 0;
+
+    size_t popped = 0;
+    while (popped < max_items && pqc_pop(pq, &out_items[popped])) {
+        popped++;
+    }
+    return popped;
+}
+
+// Quita un elemento en O(1) a partir de su handle. Con out_item lo entrega al
+// llamador (igual que pop); sin out_item se libera con su free_cb.
+bool pqc_remove(priority_queue_core_t *pq, pq_handle_t handle, pq_item_t *out_item) {
+    if (!pq || !pq->slots) return false;
+    if (out_item && pq->payload_size && !out_item->payload) return false;
+
+    pq_index_t idx = handle_slot(pq, handle);
+    if (idx == PQ_INDEX_NONE) return false;
+
+    if (out_item) {
+        take_slot(pq, idx, out_item);
+    } else {
+        discard_slot(pq, idx);
+    }
+    return true;
+}
+
+// Quita (y libera con free_cb) todos los elementos que cumplen el predicado.
+// Recorre la cola completa: O(n).
+size_t pqc_remove_if(priority_queue_core_t *pq, pq_match_fn_t match, void *ctx) {
+    if (!pq || !pq->slots || !match) return 0;
+
+    size_t removed = 0;
+    pq_index_t idx = pq->age_head;
+
+    while (idx != PQ_INDEX_NONE) {
+        pq_index_t next = pq->slots[idx].age_next;
+
+        if (match(&pq->slots[idx].item, ctx)) {
+            pq_handle_t resume = (next != PQ_INDEX_NONE) ? slot_handle(pq, next) : PQ_HANDLE_INVALID;
+            discard_slot(pq, idx);
+            removed++;
+            idx = walk_resume(pq, resume);
+        } else {
+            idx = next;
+        }
+    }
+    return removed;
+}
+
+// Handle del elemento más antiguo que cumple el predicado, o PQ_HANDLE_INVALID
+pq_handle_t pqc_find(priority_queue_core_t *pq, pq_match_fn_t match, void *ctx) {
+    if (!pq || !pq->slots || !match) return PQ_HANDLE_INVALID;
+
+    for (pq_index_t idx = pq->age_head; idx != PQ_INDEX_NONE; idx = pq->slots[idx].age_next) {
+        if (match(&pq->slots[idx].item, ctx)) {
+            return slot_handle(pq, idx);
+        }
+    }
+    return PQ_HANDLE_INVALID;
+}
+
+// Mueve un elemento a otro nivel en O(1): queda al final de la cola del nivel
+// nuevo y conserva su antigüedad global. En modo EDF el orden lo da el deadline,
+// así que solo se actualiza el campo prio.
+bool pqc_reprioritize(priority_queue_core_t *pq, pq_handle_t handle, pq_priority_t new_prio) {
+    if (!pq || !pq->slots || new_prio >= PQ_PRIO__N) return false;
+
+    pq_index_t idx = handle_slot(pq, handle);
+    if (idx == PQ_INDEX_NONE) return false;
+
+    pq_item_t *item = &pq->slots[idx].item;
+
+    if (pq->mode == PQ_MODE_LEVELS && item->prio != new_prio) {
+        level_unlink(pq, item->prio, idx);
+        item->prio = new_prio;
+        level_push_back(pq, new_prio, idx);
+    } else {
+        item->prio = new_prio;
+    }
+    return true;
+}
+
+// Descarta de una vez todos los elementos vencidos, estén donde estén: O(n).
+// Sirve para recuperar slots sin esperar a que los vencidos lleguen al frente.
+size_t pqc_purge_expired(priority_queue_core_t *pq) {
+    if (!pq || !pq->slots) return 0;
+
+    size_t purged = 0;
+    uint32_t t = now(pq);
+    pq_index_t idx = pq->age_head;
+
+    while (idx != PQ_INDEX_NONE) {
+        pq_index_t next = pq->slots[idx].age_next;
+
+        if (is_expired(pq, idx, t)) {
+            pq_handle_t resume = (next != PQ_INDEX_NONE) ? slot_handle(pq, next) : PQ_HANDLE_INVALID;
+            discard_slot(pq, idx);
+            pq->stats.expired_drops++;
+            purged++;
+            idx = walk_resume(pq, resume);
+        } else {
+            idx = next;
         }
     }
+    return purged;
+}
+
+// Préstamos (solo con payload por valor): el usuario arma o consume el mensaje
+// directamente en el slot, sin copiarlo. Ciclo del productor: pqc_loan_acquire,
+// llenar el payload, pqc_loan_commit. Ciclo del consumidor: pqc_pop_loan, usar
+// el payload, pqc_loan_release. Mientras dura el préstamo el slot cuenta como
+// ocupado para pqc_is_full, y los préstamos pendientes se pierden en pqc_destroy.
+
+// Slot prestado al que pertenece un payload, o PQ_INDEX_NONE si el puntero no
+// es el comienzo del payload de un slot prestado
+static pq_index_t loan_slot(priority_queue_core_t *pq, const void *payload) {
+    if (!pq || !pq->slots || !pq->payload_size || !payload) return PQ_INDEX_NONE;
+
+    uintptr_t base = (uintptr_t)pq->payload_storage;
+    uintptr_t addr = (uintptr_t)payload;
+    size_t stride = PQ_PAYLOAD_STRIDE(pq->payload_size);
+
+    if (addr < base || (addr - base) % stride != 0) return PQ_INDEX_NONE;
+
+    size_t idx = (addr - base) / stride;
+    if (idx >= pq->capacity || !slot_is_loaned(pq, (pq_index_t)idx)) return PQ_INDEX_NONE;
+    return (pq_index_t)idx;
+}
+
+// Reserva un slot para armar el mensaje en el lugar. item da la prioridad y el
+// resto de los campos (deadline, expiry); su payload se ignora. El contenido del
+// slot es el del último mensaje que lo ocupó. Con la cola llena se aplica la
+// política de desborde igual que en push: si descarta al entrante, no hay préstamo.
+bool pqc_loan_acquire(priority_queue_core_t *pq, pq_item_t *item, void **out_payload) {
+    if (out_payload) *out_payload = NULL;
+    if (!pq || !pq->slots || !pq->payload_size || !item || !out_payload) return false;
+    if (item->prio >= PQ_PRIO__N) return false;
+
+    pq_item_t entry = *item;
+    entry.payload = NULL;
+    entry.free_cb = NULL;
+
+    if (pqc_is_full(pq)) {
+        if (pq->total_size == 0) return false;
+        if (!apply_overflow_policy(pq, &entry, NULL)) return false;
+    }
+
+    // Sin slot solo si un free_cb reentrante ocupó el que liberó la política
+    pq_index_t idx = slot_alloc(pq);
+    if (idx == PQ_INDEX_NONE) return false;
+
+    entry.payload = slot_payload(pq, idx);
+    pq->slots[idx].item = entry;
+    slot_mark_loaned(pq, idx);
+    pq->loaned++;
+
+    *out_payload = entry.payload;
+    return true;
+}
+
+// Encola un slot obtenido con pqc_loan_acquire. El orden de llegada es el del commit.
+bool pqc_loan_commit(priority_queue_core_t *pq, void *payload, pq_handle_t *out_handle) {
+    if (out_handle) *out_handle = PQ_HANDLE_INVALID;
+
+    pq_index_t idx = loan_slot(pq, payload);
+    if (idx == PQ_INDEX_NONE) return false;
+
+    pq->slots[idx].item.seq = pq->seq_counter++;
+    enqueue_slot(pq, idx);
+    age_push_back(pq, idx);
+
+    pq->loaned--;
+    pq->total_size++;
+    pq->stats.pushed++;
+
+    if (out_handle) *out_handle = slot_handle(pq, idx);
+    return true;
+}
+
+// Igual que pqc_pop, pero el payload no se copia: out_item->payload apunta al
+// slot, que queda prestado hasta pqc_loan_release
+bool pqc_pop_loan(priority_queue_core_t *pq, pq_item_t *out_item) {
+    if (!pq || !pq->slots || !pq->payload_size || !out_item) return false;
+
+    pq_index_t idx = front_slot(pq);
+    if (idx == PQ_INDEX_NONE) return false;
+
+    *out_item = pq->slots[idx].item;
+
+    dequeue_slot(pq, idx);
+    age_unlink(pq, idx);
+    slot_mark_loaned(pq, idx);
+    pq->loaned++;
+    pq->total_size--;
+    pq->stats.popped++;
+    return true;
+}
 
-    return false;
+// Devuelve un slot prestado a la free list, tanto uno de pqc_pop_loan como uno
+// de pqc_loan_acquire que no se llegó a encolar
+bool pqc_loan_release(priority_queue_core_t *pq, void *payload) {
+    pq_index_t idx = loan_slot(pq, payload);
+    if (idx == PQ_INDEX_NONE) return false;
+
+    slot_free(pq, idx);
+    pq->loaned--;
+    return true;
 }
 
 bool pqc_is_empty(priority_queue_core_t *pq) {
     return (!pq || pq->total_size == 0);
 }
 
+// Llena = sin slots libres: los prestados también ocupan lugar
 bool pqc_is_full(priority_queue_core_t *pq) {
-    return (pq && pq->total_size >= pq->capacity);
+    return (pq && pq->total_size + pq->loaned >= pq->capacity);
 }
 
 size_t pqc_size(priority_queue_core_t *pq) {
     return pq ? pq->total_size : 0;
 }
 
+void pqc_get_stats(priority_queue_core_t *pq, pq_stats_t *out_stats) {
+    if (!pq || !out_stats) return;
+    *out_stats = pq->stats;
+}
+
+// Recorre una lista por índice (la de niveles o la de antigüedad) y verifica
+// que sea consistente en ambos sentidos. Devuelve la cantidad de nodos o -1 si está rota.
+static long check_list(priority_queue_core_t *pq, pq_index_t head, pq_index_t tail, bool by_age) {
+    long count = 0;
+    pq_index_t prev = PQ_INDEX_NONE;
+
+    for (pq_index_t idx = head; idx != PQ_INDEX_NONE; count++) {
+        if (idx >= pq->capacity || (size_t)count >= pq->capacity) return -1;
+
+        pq_slot_t *slot = &pq->slots[idx];
+        if (!(slot->gen & 1)) return -1;
+        if ((by_age ? slot->age_prev : slot->prev) != prev) return -1;
+
+        prev = idx;
+        idx = by_age ? slot->age_next : slot->next;
+    }
+    return (prev == tail) ? count : -1;
+}
+
+// Verificación completa de la estructura interna contra sus invariantes:
+// free list, lista por antigüedad, niveles y bitmap (o heap EDF), payloads por
+// valor y la conservación de los contadores. Es O(n); pensada para depuración
+// (ver PQ_CONFIG_CHECK_INVARIANTS).
+bool pqc_check_invariants(priority_queue_core_t *pq) {
+    if (!pq || !pq->slots) return false;
+    if (pq->total_size + pq->loaned > pq->capacity) return false;
+
+    // Free list: exactamente los slots libres (generación par)
+    size_t free_count = 0;
+    for (pq_index_t idx = pq->free_head; idx != PQ_INDEX_NONE; idx = pq->slots[idx].next) {
+        if (idx >= pq->capacity || free_count >= pq->capacity) return false;
+        if (pq->slots[idx].gen & 1) return false;
+        free_count++;
+    }
+    if (free_count + pq->total_size + pq->loaned != pq->capacity) return false;
+
+    // Prestados: ocupados pero marcados fuera de las listas
+    size_t loaned = 0;
+    for (size_t idx = 0; idx < pq->capacity; idx++) {
+        if (slot_is_loaned(pq, (pq_index_t)idx)) loaned++;
+    }
+    if (loaned != pq->loaned) return false;
+
+    // Lista por antigüedad: todos los elementos encolados, en orden de llegada
+    long aged = check_list(pq, pq->age_head, pq->age_tail, true);
+    if (aged < 0 || (size_t)aged != pq->total_size) return false;
+
+    for (pq_index_t idx = pq->age_head; idx != PQ_INDEX_NONE; idx = pq->slots[idx].age_next) {
+        pq_index_t next = pq->slots[idx].age_next;
+        if (next != PQ_INDEX_NONE && !serial_before(pq->slots[idx].item.seq, pq->slots[next].item.seq)) {
+            return false;
+        }
+        if (pq->payload_size && pq->slots[idx].item.payload != slot_payload(pq, idx)) {
+            return false;
+        }
+    }
+
+    if (pq->mode == PQ_MODE_EDF) {
+        // Heap: posiciones coherentes y cada padre antes que sus hijos
+        for (size_t pos = 0; pos < pq->total_size; pos++) {
+            pq_index_t idx = pq->slots[pos].heap;
+            if (idx >= pq->capacity || pq->slots[idx].heap_pos != pos) return false;
+            if (pos > 0) {
+                pq_index_t parent = pq->slots[(pos - 1) / 2].heap;
+                if (edf_before(&pq->slots[idx].item, &pq->slots[parent].item)) return false;
+            }
+        }
+    } else {
+        // Niveles: cada lista consistente, con su bit del bitmap y el prio correcto
+        size_t leveled = 0;
+        uint32_t level_bits = 0;
+        for (int level = 0; level < PQ_PRIO__N; level++) {
+            pq_level_t *q = &pq->queues[level];
+            long count = check_list(pq, q->head, q->tail, false);
+            if (count < 0) return false;
+            if (((pq->ready_bitmap & LEVEL_BIT(level)) != 0) != (count > 0)) return false;
+
+            for (pq_index_t idx = q->head; idx != PQ_INDEX_NONE; idx = pq->slots[idx].next) {
+                if ((int)pq->slots[idx].item.prio != level) return false;
+            }
+            leveled += (size_t)count;
+            level_bits |= LEVEL_BIT(level);
+        }
+        if (leveled != pq->total_size) return false;
+        if (pq->ready_bitmap & ~level_bits) return false;
+    }
+
+    // Conservación: nada se pierde ni se libera dos veces
+    return pq->stats.pushed == pq->stats.popped + pq->stats.discarded + (uint32_t)pq->total_size;
+}
+
 void pqc_destroy(priority_queue_core_t *pq) {
     if (!pq) return;
 
-    for (int i = 0; i < PQ_PRIO__N; i++) {
-        ll_clear(&pq->queues[i], free);
+    // Los elementos pendientes se liberan como cualquier descarte
+    if (pq->slots) {
+        while (pq->age_head != PQ_INDEX_NONE) {
+            discard_slot(pq, pq->age_head);
+        }
+    }
+
+    // El almacenamiento estático pertenece al llamador: solo se libera el propio
+    if (pq->owns_storage) {
+        free(pq->slots);
+    }
+    if (pq->owns_payload_storage) {
+        free(pq->payload_storage);
     }
 
+    pq->slots = NULL;
+    pq->payload_storage = NULL;
+    pq->owns_storage = false;
+    pq->owns_payload_storage = false;
     pq->total_size = 0;
 }
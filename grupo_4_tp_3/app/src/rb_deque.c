@@ -0,0 +1,113 @@
+#include "rb_deque.h"
+#include <stdlib.h>
+#include <string.h>
+
+static bool is_power_of_two(size_t n) {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+bool rb_init(rb_deque_t *rb, size_t capacity, size_t elem_size) {
+    if (!rb || !is_power_of_two(capacity) || capacity > 0x80000000u || elem_size == 0) return false;
+    if (capacity > SIZE_MAX / elem_size) return false;
+
+    // Única reserva de memoria: todo el buffer de una vez
+    void *storage = malloc(RB_STORAGE_SIZE(capacity, elem_size));
+    if (!storage) return false;
+
+    rb_init_static(rb, storage, capacity, elem_size);
+    rb->owns_buffer = true;
+
+    return true;
+}
+
+bool rb_init_static(rb_deque_t *rb, void *storage, size_t capacity, size_t elem_size) {
+    if (!rb || !storage || !is_power_of_two(capacity) || capacity > 0x80000000u || elem_size == 0) return false;
+    if (capacity > SIZE_MAX / elem_size) return false;
+
+    rb->buffer = storage;
+    rb->elem_size = elem_size;
+    rb->mask = (uint32_t)(capacity - 1);
+    rb->head = 0;
+    rb->tail = 0;
+    rb->owns_buffer = false;
+
+    return true;
+}
+
+static void *elem_at(rb_deque_t *rb, uint32_t index) {
+    return rb->buffer + (size_t)(index & rb->mask) * rb->elem_size;
+}
+
+bool rb_push_back(rb_deque_t *rb, const void *elem) {
+    if (!rb || !rb->buffer || !elem || rb_is_full(rb)) return false;
+
+    memcpy(elem_at(rb, rb->tail), elem, rb->elem_size);
+    rb->tail++;
+    return true;
+}
+
+bool rb_push_front(rb_deque_t *rb, const void *elem) {
+    if (!rb || !rb->buffer || !elem || rb_is_full(rb)) return false;
+
+    rb->head--;
+    memcpy(elem_at(rb, rb->head), elem, rb->elem_size);
+    return true;
+}
+
+bool rb_pop_front(rb_deque_t *rb, void *out_elem) {
+    if (rb_is_empty(rb)) return false;
+
+    if (out_elem) memcpy(out_elem, elem_at(rb, rb->head), rb->elem_size);
+    rb->head++;
+    return true;
+}
+
+bool rb_pop_back(rb_deque_t *rb, void *out_elem) {
+    if (rb_is_empty(rb)) return false;
+
+    rb->tail--;
+    if (out_elem) memcpy(out_elem, elem_at(rb, rb->tail), rb->elem_size);
+    return true;
+}
+
+// Punteros al elemento dentro del buffer: válidos hasta el próximo push/pop
+void* rb_peek_front(rb_deque_t *rb) {
+    return rb_is_empty(rb) ? NULL : elem_at(rb, rb->head);
+}
+
+void* rb_peek_back(rb_deque_t *rb) {
+    return rb_is_empty(rb) ? NULL : elem_at(rb, rb->tail - 1);
+}
+
+bool rb_is_empty(rb_deque_t *rb) {
+    return (!rb || rb->head == rb->tail);
+}
+
+bool rb_is_full(rb_deque_t *rb) {
+    return (rb && rb->buffer && rb->tail - rb->head > rb->mask);
+}
+
+size_t rb_size(rb_deque_t *rb) {
+    return rb ? (size_t)(rb->tail - rb->head) : 0;
+}
+
+size_t rb_capacity(rb_deque_t *rb) {
+    return (rb && rb->buffer) ? (size_t)rb->mask + 1 : 0;
+}
+
+void rb_clear(rb_deque_t *rb) {
+    if (!rb) return;
+    rb->head = 0;
+    rb->tail = 0;
+}
+
+void rb_destroy(rb_deque_t *rb) {
+    if (!rb) return;
+
+    if (rb->owns_buffer) free(rb->buffer);
+
+    rb->buffer = NULL;
+    rb->owns_buffer = false;
+    rb->head = 0;
+    rb->tail = 0;
+}
@@ -76,9 +76,9 @@ void task_led(void *argument)
 
 	while (true)
 	{
-	    ui_led_msg_t *job = NULL;
+	    ui_led_msg_t *job;
 
-	    if (pdPASS == xPriorityQueueReceive(hq, (void**)&job, PQ_WAITING_PERIOD_MS))
+	    if (pdPASS == xPriorityQueueReceiveLoan(hq, (void**)&job, PQ_WAITING_PERIOD_MS))
 	    {
 			switch (job->color) {
 				case UI_LED_RED:
@@ -101,9 +101,10 @@ void task_led(void *argument)
 
 				default:
 					break;
-					vPortFree(job);
 			}
 
+			// El mensaje se usó en el lugar: se devuelve el slot a la cola
+			vPriorityQueueRelease(hq, job);
 		}
 	}
 }
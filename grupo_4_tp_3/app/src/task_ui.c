@@ -53,6 +53,7 @@
 #define QUEUE_LENGTH_            (5)
 #define QUEUE_ITEM_SIZE_         (sizeof(msg_event_t))
 #define UI_PQ_CAPACITY   		 10
+#define UI_PQ_AGING_MS           10000   // Espera (dos jobs de LED) tras la que un job sube de nivel
 
 /********************** internal data declaration ****************************/
 typedef struct
@@ -64,6 +65,8 @@ typedef struct
 /********************** internal data definition *****************************/
 static ao_ui_handle_t hao_;
 static PriorityQueueHandle_t hq_ui2led = NULL;
+static StaticPriorityQueue_t pq_ui2led_cb_;
+static pq_slot_t pq_ui2led_storage_[PRIORITY_QUEUE_STORAGE_LEN(UI_PQ_CAPACITY, sizeof(ui_led_msg_t))];
 /********************** external data definition *****************************/
 uint8_t idOrder = 0;
 
@@ -73,14 +76,16 @@ uint8_t idOrder = 0;
 
 static void send_led_job_(ui_led_color_t color, pq_priority_t prio)
 {
-  ui_led_msg_t *job = pvPortMalloc(sizeof(*job));
-  if (!job) return; // manejar error si querés
-
-  job->prio = prio;
-  job->color = color;
-  job->on_time_ms = 5000;
-  job->id = idOrder;
-  (void)xPriorityQueueSend(hq_ui2led, (void* const*)&job, 0);
+  // El mensaje se arma directamente en un slot de la cola: sin copia
+  ui_led_msg_t *job;
+  if (pdPASS == xPriorityQueueAcquireSlot(hq_ui2led, prio, (void**)&job, 0))
+  {
+    job->prio = prio;
+    job->color = color;
+    job->on_time_ms = 5000;
+    job->id = idOrder;
+    (void)xPriorityQueueCommit(hq_ui2led, job, NULL);
+  }
   idOrder++;
 }
 
@@ -127,9 +132,14 @@ PriorityQueueHandle_t ao_ui_init(void)
 	// error
 	}
 
-	hq_ui2led = xPriorityQueueCreate(UI_PQ_CAPACITY, sizeof(void*));
+	hq_ui2led = xPriorityQueueCreateStatic(UI_PQ_CAPACITY, sizeof(ui_led_msg_t), pq_ui2led_storage_, &pq_ui2led_cb_);
 	configASSERT(hq_ui2led != NULL);
 
+	// Bajo sobrecarga se descartan primero los jobs menos urgentes (azul)
+	vPriorityQueueSetOverflowPolicy(hq_ui2led, PQ_OVERFLOW_DROP_LOWEST);
+	// Y con pulsos seguidos los jobs azules igual terminan saliendo
+	vPriorityQueueSetAging(hq_ui2led, pdMS_TO_TICKS(UI_PQ_AGING_MS));
+
 	BaseType_t status;
 	status = xTaskCreate(task_ui, "task_ao_ui", 128, NULL, tskIDLE_PRIORITY + 1, NULL);
 	while (pdPASS != status)
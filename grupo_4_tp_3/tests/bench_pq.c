@@ -0,0 +1,469 @@
+// Microbenchmarks en host (Linux) de linked_list y priority_queue_core.
+// Para cada estructura, operación y capacidad (10 a 100000) imprime una línea
+// JSON en stdout, p. ej.:
+//   {"ds":"pqc","op":"push","levels":3,"n":1000,"ns":9.81,"allocs":0.000}
+// "ns" es el tiempo por operación (clock_gettime) y "allocs" la cantidad de
+// malloc/calloc/realloc por operación, contados envolviendo esas funciones con
+// -Wl,--wrap (ver Makefile). Estructuras: "ll" lista con malloc, "llp" lista con
+// pool, "lli" lista intrusiva, "rb" deque circular, "pqc" cola y "rbq" niveles de
+// rb_deque_t, para comparar con las listas de slots del core (mismos casos que
+// "pqc" salvo "ovf"). Los índices del core son de 16 bits:
+// con n mayor que PQ_CAPACITY_MAX, "pqc" se mide y se reporta con PQ_CAPACITY_MAX.
+// "levels" es PQ_CONFIG_NUM_LEVELS: con el argumento "ovf" solo se miden los
+// push con la cola llena, para comparar builds con distinta cantidad de niveles.
+//
+//   make -s bench > bench.json
+//   make -s bench-levels         "ovf" con 3, 8, 16 y 32 niveles
+
+#include "priority_queue_core.h"
+#include "linked_list.h"
+#include "rb_deque.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Cada caso se repite hasta sumar al menos esta cantidad de operaciones, para
+// que el tiempo de las capacidades chicas no quede dominado por clock_gettime
+#define BENCH_MIN_OPS       1000000UL
+#define BENCH_MAX_CAPACITY  100000UL
+
+typedef struct {
+    uint64_t ns;
+    unsigned long allocs;
+    unsigned long ops;
+    uint64_t start_ns;
+    unsigned long start_allocs;
+} bench_t;
+
+static unsigned long alloc_count;
+
+// Envolturas de -Wl,--wrap: solo cuentan, la reserva la hace la libc
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    alloc_count++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    alloc_count++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    alloc_count++;
+    return __real_realloc(ptr, size);
+}
+
+// Payload de relleno: las estructuras solo guardan el puntero
+static uint8_t dummy;
+static uint32_t rand_state = 1;
+
+// Generador congruencial: reproducible entre corridas y entre máquinas
+static uint32_t bench_rand(void) {
+    rand_state = rand_state * 1664525u + 1013904223u;
+    return rand_state >> 16;
+}
+
+// 1 de cada 8 urgente, el resto al nivel menos urgente
+static pq_priority_t skewed_prio(void) {
+    return (bench_rand() & 7) ? PQ_PRIO_LOW : PQ_PRIO_HIGH;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static size_t reps_for(size_t n) {
+    return (n >= BENCH_MIN_OPS) ? 1 : (BENCH_MIN_OPS + n - 1) / n;
+}
+
+static void phase_begin(bench_t *b) {
+    b->start_allocs = alloc_count;
+    b->start_ns = now_ns();
+}
+
+static void phase_end(bench_t *b, size_t ops) {
+    b->ns += now_ns() - b->start_ns;
+    b->allocs += alloc_count - b->start_allocs;
+    b->ops += ops;
+}
+
+static void report(const char *ds, const char *op, size_t n, const bench_t *b) {
+    printf("{\"ds\":\"%s\",\"op\":\"%s\",\"levels\":%d,\"n\":%zu,\"ns\":%.2f,\"allocs\":%.3f}\n",
+           ds, op, PQ_PRIO__N, n, (double)b->ns / (double)b->ops, (double)b->allocs / (double)b->ops);
+}
+
+// Con pool NULL los nodos salen de malloc ("ll"); si no, del pool ("llp")
+static void bench_ll(size_t n, ll_pool_t *pool) {
+    const char *ds = pool ? "llp" : "ll";
+    bench_t push = { 0 }, pop = { 0 }, mix = { 0 };
+    linked_list_t list;
+
+    ll_init_with_pool(&list, pool);
+
+    for (size_t rep = reps_for(n); rep > 0; rep--) {
+        // push: de vacía a n elementos
+        phase_begin(&push);
+        for (size_t i = 0; i < n; i++) {
+            ll_push_back(&list, &dummy);
+        }
+        phase_end(&push, n);
+
+        // pop: vaciar
+        phase_begin(&pop);
+        for (size_t i = 0; i < n; i++) {
+            ll_pop_front(&list);
+        }
+        phase_end(&pop, n);
+    }
+
+    // mix: push + pop alternados con la lista a media carga
+    for (size_t i = 0; i < n / 2; i++) {
+        ll_push_back(&list, &dummy);
+    }
+    for (size_t rep = reps_for(2 * n); rep > 0; rep--) {
+        phase_begin(&mix);
+        for (size_t i = 0; i < n; i++) {
+            ll_push_back(&list, &dummy);
+            ll_pop_front(&list);
+        }
+        phase_end(&mix, 2 * n);
+    }
+    ll_clear(&list, NULL);
+
+    report(ds, "push", n, &push);
+    report(ds, "pop", n, &pop);
+    report(ds, "mix", n, &mix);
+}
+
+static void bench_ll_pool(size_t n) {
+    ll_pool_t pool;
+
+    // El arreglo del pool se reserva una vez, fuera de la medición
+    ll_node_t *storage = malloc(n * sizeof(ll_node_t));
+    if (!storage || !ll_pool_init(&pool, storage, n)) {
+        fprintf(stderr, "bench_pq: sin memoria para el pool de %zu nodos\n", n);
+        exit(1);
+    }
+
+    bench_ll(n, &pool);
+    free(storage);
+}
+
+typedef struct {
+    ll_link_t link;
+    uint32_t value;
+} bench_node_t;
+
+static void bench_lli(size_t n) {
+    bench_t push = { 0 }, pop = { 0 }, mix = { 0 };
+    lli_list_t list;
+
+    // Los nodos los pone el usuario: se reservan una vez, fuera de la medición
+    bench_node_t *nodes = malloc(n * sizeof(bench_node_t));
+    if (!nodes) {
+        fprintf(stderr, "bench_pq: sin memoria para %zu nodos\n", n);
+        exit(1);
+    }
+
+    lli_init(&list);
+
+    for (size_t rep = reps_for(n); rep > 0; rep--) {
+        phase_begin(&push);
+        for (size_t i = 0; i < n; i++) {
+            lli_push_back(&list, &nodes[i].link);
+        }
+        phase_end(&push, n);
+
+        phase_begin(&pop);
+        for (size_t i = 0; i < n; i++) {
+            lli_pop_front(&list);
+        }
+        phase_end(&pop, n);
+    }
+
+    for (size_t i = 0; i < n / 2; i++) {
+        lli_push_back(&list, &nodes[i].link);
+    }
+    for (size_t rep = reps_for(2 * n); rep > 0; rep--) {
+        phase_begin(&mix);
+        for (size_t i = 0; i < n; i++) {
+            lli_push_back(&list, lli_pop_front(&list));
+        }
+        phase_end(&mix, 2 * n);
+    }
+
+    report("lli", "push", n, &push);
+    report("lli", "pop", n, &pop);
+    report("lli", "mix", n, &mix);
+
+    free(nodes);
+}
+
+// La capacidad de rb_deque_t tiene que ser potencia de 2
+static size_t rb_capacity_for(size_t n) {
+    size_t capacity = 1;
+    while (capacity < n) capacity <<= 1;
+    return capacity;
+}
+
+// Mismo patrón que las listas, guardando el puntero por valor en el buffer circular
+static void bench_rb(size_t n) {
+    bench_t push = { 0 }, pop = { 0 }, mix = { 0 };
+    rb_deque_t rb;
+    void *elem = &dummy;
+
+    if (!rb_init(&rb, rb_capacity_for(n), sizeof(void*))) {
+        fprintf(stderr, "bench_pq: sin memoria para el deque de %zu\n", n);
+        exit(1);
+    }
+
+    for (size_t rep = reps_for(n); rep > 0; rep--) {
+        phase_begin(&push);
+        for (size_t i = 0; i < n; i++) {
+            rb_push_back(&rb, &elem);
+        }
+        phase_end(&push, n);
+
+        phase_begin(&pop);
+        for (size_t i = 0; i < n; i++) {
+            rb_pop_front(&rb, &elem);
+        }
+        phase_end(&pop, n);
+    }
+
+    for (size_t i = 0; i < n / 2; i++) {
+        rb_push_back(&rb, &elem);
+    }
+    for (size_t rep = reps_for(2 * n); rep > 0; rep--) {
+        phase_begin(&mix);
+        for (size_t i = 0; i < n; i++) {
+            rb_push_back(&rb, &elem);
+            rb_pop_front(&rb, &elem);
+        }
+        phase_end(&mix, 2 * n);
+    }
+
+    report("rb", "push", n, &push);
+    report("rb", "pop", n, &pop);
+    report("rb", "mix", n, &mix);
+
+    rb_destroy(&rb);
+}
+
+static size_t pqc_capacity(size_t n) {
+    return (n > PQ_CAPACITY_MAX) ? PQ_CAPACITY_MAX : n;
+}
+
+// Cola llena con elementos en todos los niveles: cada push descarta según la
+// política. El costo no tendría que depender de la cantidad de niveles.
+static void bench_pqc_overflow(size_t n, pq_overflow_policy_t policy, const char *op) {
+    bench_t ovf = { 0 };
+    priority_queue_core_t pq;
+    pq_item_t item = { .payload = &dummy };
+
+    n = pqc_capacity(n);
+    if (!pqc_init(&pq, n) || !pqc_set_overflow_policy(&pq, policy)) {
+        fprintf(stderr, "bench_pq: no se pudo crear la cola de %zu\n", n);
+        exit(1);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        item.prio = (pq_priority_t)(i % PQ_PRIO__N);
+        pqc_push(&pq, &item);
+    }
+
+    for (size_t rep = reps_for(n); rep > 0; rep--) {
+        phase_begin(&ovf);
+        for (size_t i = 0; i < n; i++) {
+            item.prio = (pq_priority_t)(bench_rand() % PQ_PRIO__N);
+            pqc_push(&pq, &item);
+        }
+        phase_end(&ovf, n);
+    }
+
+    report("pqc", op, n, &ovf);
+    pqc_destroy(&pq);
+}
+
+static void bench_pqc(size_t n) {
+    bench_t push = { 0 }, pop = { 0 }, mix = { 0 }, skew = { 0 };
+    priority_queue_core_t pq;
+    pq_item_t item = { .payload = &dummy };
+    pq_item_t out;
+
+    n = pqc_capacity(n);
+    if (!pqc_init(&pq, n)) {
+        fprintf(stderr, "bench_pq: no se pudo crear la cola de %zu\n", n);
+        exit(1);
+    }
+    rand_state = 1;     // Misma secuencia de prioridades que bench_rbq
+
+    for (size_t rep = reps_for(n); rep > 0; rep--) {
+        // push: de vacía a llena, niveles repartidos
+        phase_begin(&push);
+        for (size_t i = 0; i < n; i++) {
+            item.prio = (pq_priority_t)(i % PQ_PRIO__N);
+            pqc_push(&pq, &item);
+        }
+        phase_end(&push, n);
+
+        // pop: vaciar
+        phase_begin(&pop);
+        for (size_t i = 0; i < n; i++) {
+            pqc_pop(&pq, &out);
+        }
+        phase_end(&pop, n);
+    }
+
+    // mix: push + pop alternados con la cola a media carga, prioridad al azar
+    for (size_t i = 0; i < n / 2; i++) {
+        item.prio = (pq_priority_t)(bench_rand() % PQ_PRIO__N);
+        pqc_push(&pq, &item);
+    }
+    for (size_t rep = reps_for(2 * n); rep > 0; rep--) {
+        phase_begin(&mix);
+        for (size_t i = 0; i < n; i++) {
+            item.prio = (pq_priority_t)(bench_rand() % PQ_PRIO__N);
+            pqc_push(&pq, &item);
+            pqc_pop(&pq, &out);
+        }
+        phase_end(&mix, 2 * n);
+    }
+    while (pqc_pop(&pq, &out)) {
+    }
+
+    // skew: llenar con casi todo en un nivel y vaciar
+    for (size_t rep = reps_for(2 * n); rep > 0; rep--) {
+        phase_begin(&skew);
+        for (size_t i = 0; i < n; i++) {
+            item.prio = skewed_prio();
+            pqc_push(&pq, &item);
+        }
+        for (size_t i = 0; i < n; i++) {
+            pqc_pop(&pq, &out);
+        }
+        phase_end(&skew, 2 * n);
+    }
+
+    report("pqc", "push", n, &push);
+    report("pqc", "pop", n, &pop);
+    report("pqc", "mix", n, &mix);
+    report("pqc", "skew", n, &skew);
+
+    pqc_destroy(&pq);
+}
+
+// Niveles de rb_deque_t con los pq_item_t por valor, como alternativa a las
+// listas de slots del core. Solo el contenedor: sin política de desborde, ni
+// orden global por antigüedad, ni quitar por handle (que un buffer circular no
+// puede hacer en O(1) desde el medio de un nivel).
+typedef struct {
+    rb_deque_t levels[PQ_PRIO__N];
+} rb_levels_t;
+
+static void rbq_push(rb_levels_t *q, pq_item_t *item) {
+    rb_push_back(&q->levels[item->prio], item);
+}
+
+static bool rbq_pop(rb_levels_t *q, pq_item_t *out) {
+    for (int level = 0; level < PQ_PRIO__N; level++) {
+        if (rb_pop_front(&q->levels[level], out)) return true;
+    }
+    return false;
+}
+
+// Mismos casos que bench_pqc, con la misma secuencia de prioridades
+static void bench_rbq(size_t n) {
+    bench_t push = { 0 }, pop = { 0 }, mix = { 0 }, skew = { 0 };
+    rb_levels_t q;
+    pq_item_t item = { .payload = &dummy };
+    pq_item_t out;
+
+    // Cualquier nivel puede llegar a tener los n elementos
+    n = pqc_capacity(n);
+    for (int level = 0; level < PQ_PRIO__N; level++) {
+        if (!rb_init(&q.levels[level], rb_capacity_for(n), sizeof(pq_item_t))) {
+            fprintf(stderr, "bench_pq: sin memoria para los niveles de %zu\n", n);
+            exit(1);
+        }
+    }
+    rand_state = 1;     // Misma secuencia de prioridades que bench_pqc
+
+    for (size_t rep = reps_for(n); rep > 0; rep--) {
+        phase_begin(&push);
+        for (size_t i = 0; i < n; i++) {
+            item.prio = (pq_priority_t)(i % PQ_PRIO__N);
+            rbq_push(&q, &item);
+        }
+        phase_end(&push, n);
+
+        phase_begin(&pop);
+        for (size_t i = 0; i < n; i++) {
+            rbq_pop(&q, &out);
+        }
+        phase_end(&pop, n);
+    }
+
+    for (size_t i = 0; i < n / 2; i++) {
+        item.prio = (pq_priority_t)(bench_rand() % PQ_PRIO__N);
+        rbq_push(&q, &item);
+    }
+    for (size_t rep = reps_for(2 * n); rep > 0; rep--) {
+        phase_begin(&mix);
+        for (size_t i = 0; i < n; i++) {
+            item.prio = (pq_priority_t)(bench_rand() % PQ_PRIO__N);
+            rbq_push(&q, &item);
+            rbq_pop(&q, &out);
+        }
+        phase_end(&mix, 2 * n);
+    }
+    while (rbq_pop(&q, &out)) {
+    }
+
+    for (size_t rep = reps_for(2 * n); rep > 0; rep--) {
+        phase_begin(&skew);
+        for (size_t i = 0; i < n; i++) {
+            item.prio = skewed_prio();
+            rbq_push(&q, &item);
+        }
+        for (size_t i = 0; i < n; i++) {
+            rbq_pop(&q, &out);
+        }
+        phase_end(&skew, 2 * n);
+    }
+
+    report("rbq", "push", n, &push);
+    report("rbq", "pop", n, &pop);
+    report("rbq", "mix", n, &mix);
+    report("rbq", "skew", n, &skew);
+
+    for (int level = 0; level < PQ_PRIO__N; level++) {
+        rb_destroy(&q.levels[level]);
+    }
+}
+
+int main(int argc, char **argv) {
+    bool only_overflow = (argc > 1 && strcmp(argv[1], "ovf") == 0);
+
+    for (size_t n = 10; n <= BENCH_MAX_CAPACITY; n *= 10) {
+        if (!only_overflow) {
+            bench_ll(n, NULL);
+            bench_ll_pool(n);
+            bench_lli(n);
+            bench_rb(n);
+            bench_pqc(n);
+            bench_rbq(n);
+        }
+        bench_pqc_overflow(n, PQ_OVERFLOW_DROP_OLDEST, "ovf");
+        bench_pqc_overflow(n, PQ_OVERFLOW_DROP_LOWEST, "ovf_lowest");
+    }
+    return 0;
+}
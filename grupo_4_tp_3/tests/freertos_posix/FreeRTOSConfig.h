@@ -0,0 +1,41 @@
+// Configuración de FreeRTOS para correr el wrapper en host con el port POSIX
+// (ver stress_pq.c). Sigue la del demo de ese port: cada tarea es un pthread
+// que usa su stack de FreeRTOS, por eso el mínimo es PTHREAD_STACK_MIN.
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <limits.h>
+
+#define configUSE_PREEMPTION                     1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION  0
+#define configSUPPORT_STATIC_ALLOCATION          0
+#define configSUPPORT_DYNAMIC_ALLOCATION         1
+#define configUSE_IDLE_HOOK                      0
+#define configUSE_TICK_HOOK                      0
+#define configTICK_RATE_HZ                       ((TickType_t)1000)
+#define configMAX_PRIORITIES                     ( 7 )
+#define configMINIMAL_STACK_SIZE                 ((unsigned short)PTHREAD_STACK_MIN)
+#define configTOTAL_HEAP_SIZE                    ((size_t)(4 * 1024 * 1024))
+#define configMAX_TASK_NAME_LEN                  ( 16 )
+#define configUSE_16_BIT_TICKS                   0
+#define configIDLE_SHOULD_YIELD                  1
+#define configUSE_TASK_NOTIFICATIONS             1
+#define configUSE_MUTEXES                        1
+#define configQUEUE_REGISTRY_SIZE                0
+#define configUSE_CO_ROUTINES                    0
+#define configUSE_TIMERS                         0
+#define configCHECK_FOR_STACK_OVERFLOW           0
+#define configUSE_MALLOC_FAILED_HOOK             0
+
+#define INCLUDE_uxTaskPriorityGet                1
+#define INCLUDE_vTaskDelete                      1
+#define INCLUDE_vTaskSuspend                     1
+#define INCLUDE_vTaskDelay                       1
+#define INCLUDE_xTaskGetCurrentTaskHandle        1
+
+// Una verificación fallida termina la prueba con el archivo y la línea
+void vAssertCalled(const char *file, unsigned long line);
+#define configASSERT( x ) if ((x) == 0) { vAssertCalled(__FILE__, __LINE__); }
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,57 @@
+// main para correr fuzz_pq.c sin libFuzzer (p. ej. con gcc): con archivos como
+// argumentos los reproduce (un crash guardado por libFuzzer); sin argumentos
+// genera entradas al azar.
+//
+// Uso: fuzz_pq_replay [archivo ...]    o    fuzz_pq_replay -n <entradas> [semilla]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_INPUT_SIZE  4096
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static int replay_file(const char *path) {
+    static uint8_t buffer[1 << 20];
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    size_t size = fread(buffer, 1, sizeof(buffer), f);
+    fclose(f);
+
+    LLVMFuzzerTestOneInput(buffer, size);
+    return 0;
+}
+
+static void run_random(unsigned long inputs, unsigned long seed) {
+    static uint8_t buffer[MAX_INPUT_SIZE];
+
+    srand((unsigned)seed);
+    for (unsigned long i = 0; i < inputs; i++) {
+        size_t size = (size_t)rand() % MAX_INPUT_SIZE;
+        for (size_t j = 0; j < size; j++) {
+            buffer[j] = (uint8_t)rand();
+        }
+        LLVMFuzzerTestOneInput(buffer, size);
+    }
+    printf("fuzz_pq: %lu entradas al azar OK (semilla %lu)\n", inputs, seed);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "-n") != 0) {
+        for (int i = 1; i < argc; i++) {
+            if (replay_file(argv[i]) != 0) return 1;
+        }
+        return 0;
+    }
+
+    unsigned long inputs = (argc > 2) ? strtoul(argv[2], NULL, 0) : 20000UL;
+    unsigned long seed = (argc > 3) ? strtoul(argv[3], NULL, 0) : 1;
+    run_random(inputs, seed);
+    return 0;
+}
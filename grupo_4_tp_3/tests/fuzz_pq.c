@@ -0,0 +1,395 @@
+// Objetivo de libFuzzer: cada entrada se decodifica como una configuración de
+// cola (capacidad desde 1, modo, política, payload por valor o por puntero)
+// seguida de operaciones sobre pqc_*, o como operaciones sobre ll_* o rb_*. Incluye payloads NULL, handles
+// vencidos, préstamos y un free_cb que vuelve a entrar al core. Después de cada
+// operación se verifican los invariantes; los errores de memoria los detectan
+// ASan/UBSan y las pérdidas LeakSanitizer.
+//
+//   make fuzz          con clang y -fsanitize=fuzzer,address,undefined
+//   make check         también corre entradas al azar con fuzz_main.c (gcc)
+
+#include "priority_queue_core.h"
+#include "linked_list.h"
+#include "rb_deque.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_MAX_CAPACITY   8
+#define FUZZ_HANDLES        8
+#define FUZZ_POOL_NODES     4
+#define FUZZ_REF_NODES      16
+#define FUZZ_RB_MAX_LOG2    4
+#define FUZZ_RB_MAX_ELEM    8
+
+#define FUZZ_CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: falló '%s'\n", __FILE__, __LINE__, #cond); \
+        abort(); \
+    } \
+} while (0)
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+} fuzz_input_t;
+
+// Préstamo pendiente: committable solo si salió de pqc_loan_acquire
+typedef struct {
+    void *payload;
+    bool acquired;
+} fuzz_loan_t;
+
+static priority_queue_core_t pq;
+static bool by_value;
+static size_t payload_size;
+static pq_handle_t handles[FUZZ_HANDLES];
+static fuzz_loan_t loans[FUZZ_MAX_CAPACITY];
+static size_t loan_count;
+static uint32_t now_ticks;
+static bool in_callback;
+static bool destroying;
+static uint8_t reentry_op;
+static bool reentry_pending;    // Un solo reingreso por operación: un free_cb que
+                                // siempre vuelve a encolar haría infinito un remove_if
+
+static uint8_t next_byte(fuzz_input_t *in) {
+    if (in->size == 0) return 0;
+    in->size--;
+    return *in->data++;
+}
+
+static uint32_t fuzz_clock(void) {
+    return now_ticks;
+}
+
+static bool match_prio(const pq_item_t *item, void *ctx) {
+    return item->prio == *(pq_priority_t*)ctx;
+}
+
+static void free_token(void *payload);
+
+// Payload por puntero: bloque de malloc (o NULL) que la cola libera con free_token.
+// Por valor: el core copia payload_size bytes y no libera nada.
+static bool push_token(uint8_t prio, uint8_t extra, pq_handle_t *out_handle) {
+    uint8_t buffer[32];
+    pq_item_t item = {
+        .prio = (pq_priority_t)(prio % (PQ_PRIO__N + 1)),  // A veces inválida
+        .deadline = now_ticks + extra,
+        .expiry = (extra & 0x80) ? now_ticks + (extra & 0x0F) + 1 : 0,
+        .free_cb = free_token,
+    };
+
+    if (by_value) {
+        memset(buffer, extra, sizeof(buffer));
+        item.payload = (extra & 0x40) ? NULL : buffer;
+    } else if (!(extra & 0x40)) {
+        item.payload = malloc(1);
+    }
+
+    bool pushed = pqc_push_ex(&pq, &item, out_handle);
+
+    // Rechazado: el payload sigue siendo del llamador
+    if (!pushed && !by_value) free(item.payload);
+    return pushed;
+}
+
+// free_cb: además de liberar, a veces vuelve a entrar al core (un nivel)
+static void free_token(void *payload) {
+    FUZZ_CHECK(!by_value);
+    free(payload);
+
+    if (in_callback || destroying || !reentry_pending) return;
+    in_callback = true;
+    reentry_pending = false;
+
+    pq_item_t out;
+    pq_priority_t prio = (pq_priority_t)(reentry_op % PQ_PRIO__N);
+    switch (reentry_op % 4) {
+        case 0:
+            break;
+        case 1:
+            push_token(reentry_op, reentry_op, NULL);
+            break;
+        case 2:
+            if (pqc_pop(&pq, &out)) free(out.payload);
+            break;
+        case 3:
+            pqc_remove_if(&pq, match_prio, &prio);
+            break;
+    }
+    FUZZ_CHECK(pqc_check_invariants(&pq));
+
+    in_callback = false;
+}
+
+static void loan_forget(size_t i) {
+    loans[i] = loans[--loan_count];
+}
+
+static void fuzz_pqc_op(fuzz_input_t *in, uint8_t op) {
+    uint8_t arg = next_byte(in);
+    uint8_t extra = next_byte(in);
+    pq_handle_t *slot = &handles[arg % FUZZ_HANDLES];
+    pq_priority_t prio = (pq_priority_t)(arg % PQ_PRIO__N);
+    uint8_t out_buffer[32];
+    pq_item_t out = { .payload = out_buffer };
+    void *loaned;
+
+    reentry_op = extra;
+    reentry_pending = true;
+
+    switch (op % 12) {
+        case 0:
+            push_token(arg, extra, slot);
+            break;
+        case 1:
+            out.payload = by_value ? out_buffer : NULL;
+            if (pqc_pop(&pq, &out) && !by_value) free(out.payload);
+            break;
+        case 2:
+            // Handle posiblemente vencido: tiene que fallar sin tocar nada
+            out.payload = by_value ? out_buffer : NULL;
+            if (pqc_remove(&pq, *slot, (extra & 1) ? &out : NULL) && (extra & 1) && !by_value) {
+                free(out.payload);
+            }
+            break;
+        case 3:
+            pqc_reprioritize(&pq, *slot, (pq_priority_t)(extra % (PQ_PRIO__N + 1)));
+            break;
+        case 4:
+            pqc_remove_if(&pq, match_prio, &prio);
+            break;
+        case 5:
+            *slot = pqc_find(&pq, match_prio, &prio);
+            break;
+        case 6:
+            now_ticks += extra;
+            if (arg & 1) pqc_purge_expired(&pq);
+            break;
+        case 7:
+            pqc_set_aging(&pq, extra % 4);
+            break;
+        case 8:
+            if (by_value && loan_count < FUZZ_MAX_CAPACITY) {
+                pq_item_t item = { .prio = (pq_priority_t)(arg % (PQ_PRIO__N + 1)), .deadline = now_ticks + extra };
+                if (pqc_loan_acquire(&pq, &item, &loaned)) {
+                    memset(loaned, extra, payload_size);
+                    loans[loan_count++] = (fuzz_loan_t){ loaned, true };
+                }
+            }
+            break;
+        case 9:
+            if (by_value && loan_count < FUZZ_MAX_CAPACITY && pqc_pop_loan(&pq, &out)) {
+                loans[loan_count++] = (fuzz_loan_t){ out.payload, false };
+            }
+            break;
+        case 10:
+            if (loan_count > 0) {
+                size_t i = arg % loan_count;
+                if (loans[i].acquired && (extra & 1)) {
+                    FUZZ_CHECK(pqc_loan_commit(&pq, loans[i].payload, slot));
+                } else {
+                    FUZZ_CHECK(pqc_loan_release(&pq, loans[i].payload));
+                }
+                // Ya devuelto: un segundo intento tiene que fallar
+                FUZZ_CHECK(!pqc_loan_release(&pq, loans[i].payload));
+                loan_forget(i);
+            }
+            break;
+        case 11:
+            // Puntero que no es el comienzo de un payload prestado
+            if (loan_count > 0) {
+                FUZZ_CHECK(!pqc_loan_commit(&pq, (uint8_t*)loans[0].payload + 1, NULL));
+            }
+            break;
+    }
+    FUZZ_CHECK(pqc_check_invariants(&pq));
+}
+
+static void fuzz_pqc(fuzz_input_t *in) {
+    uint8_t config = next_byte(in);
+    size_t capacity = 1 + next_byte(in) % FUZZ_MAX_CAPACITY;
+
+    FUZZ_CHECK(pqc_init(&pq, capacity));
+    pqc_set_clock(&pq, fuzz_clock);
+    pqc_set_mode(&pq, (pq_mode_t)((config >> 1) % PQ_MODE__N));
+    pqc_set_overflow_policy(&pq, (pq_overflow_policy_t)((config >> 2) % PQ_OVERFLOW__N));
+
+    by_value = config & 1;
+    payload_size = 1 + (config >> 4);
+    if (by_value) FUZZ_CHECK(pqc_set_inline_payload(&pq, NULL, payload_size));
+
+    memset(handles, 0xFF, sizeof(handles));
+    loan_count = 0;
+    now_ticks = 0;
+
+    size_t ops = next_byte(in);
+    for (size_t i = 0; i < ops && in->size > 0; i++) {
+        fuzz_pqc_op(in, next_byte(in));
+    }
+
+    destroying = true;
+    pqc_destroy(&pq);
+    destroying = false;
+}
+
+// Listas: una con malloc y dos con el mismo pool, para probar splice entre
+// listas compatibles e incompatibles. Los datos no son de la lista.
+static void fuzz_ll(fuzz_input_t *in) {
+    static int refs[FUZZ_REF_NODES];
+    ll_node_t storage[FUZZ_POOL_NODES];
+    ll_pool_t pool;
+    linked_list_t lists[3];
+
+    FUZZ_CHECK(ll_pool_init(&pool, storage, FUZZ_POOL_NODES));
+    ll_init(&lists[0]);
+    ll_init_with_pool(&lists[1], &pool);
+    ll_init_with_pool(&lists[2], &pool);
+
+    size_t ops = next_byte(in);
+    for (size_t i = 0; i < ops && in->size > 0; i++) {
+        uint8_t op = next_byte(in);
+        uint8_t arg = next_byte(in);
+        linked_list_t *list = &lists[op % 3];
+        void *data = (arg & 0x80) ? NULL : &refs[arg % FUZZ_REF_NODES];
+
+        switch ((op / 3) % 6) {
+            case 0:
+                FUZZ_CHECK(ll_push_back(list, data) || !data || list->pool);
+                break;
+            case 1:
+                ll_pop_front(list);
+                break;
+            case 2:
+                ll_insert_before(list, (arg & 1) ? ll_first(list) : NULL, data);
+                break;
+            case 3:
+                ll_remove(list, ll_first(list));
+                break;
+            case 4:
+                FUZZ_CHECK(ll_splice_back(list, &lists[arg % 3]) == (list->pool == lists[arg % 3].pool));
+                break;
+            case 5:
+                ll_clear(list, NULL);
+                break;
+        }
+
+        // El recorrido tiene que coincidir con el tamaño, y el pool con lo usado
+        size_t pooled = 0;
+        for (int l = 0; l < 3; l++) {
+            size_t count = 0;
+            for (ll_node_t *node = ll_first(&lists[l]); node; node = ll_next(node)) {
+                FUZZ_CHECK(node->data != NULL);
+                count++;
+            }
+            FUZZ_CHECK(count == ll_size(&lists[l]));
+            if (lists[l].pool) pooled += count;
+        }
+        FUZZ_CHECK(pooled == pool.used);
+    }
+
+    for (int l = 0; l < 3; l++) {
+        ll_clear(&lists[l], NULL);
+    }
+}
+
+// Deque circular contra un modelo en arreglo (el frente es model[0]). El buffer
+// es siempre de malloc, también con rb_init_static, para que ASan vea sus bordes.
+static void fuzz_rb(fuzz_input_t *in) {
+    static uint8_t model[1 << FUZZ_RB_MAX_LOG2][FUZZ_RB_MAX_ELEM];
+    uint8_t config = next_byte(in);
+    size_t capacity = (size_t)1 << (config % (FUZZ_RB_MAX_LOG2 + 1));
+    size_t elem_size = 1 + (config >> 4) % FUZZ_RB_MAX_ELEM;
+    size_t model_size = 0;
+    uint8_t elem[FUZZ_RB_MAX_ELEM];
+    void *storage = NULL;
+    rb_deque_t rb;
+
+    // Capacidad que no es potencia de 2: se rechaza
+    FUZZ_CHECK(capacity < 4 || !rb_init(&rb, capacity - 1, elem_size));
+
+    if (config & 8) {
+        storage = malloc(RB_STORAGE_SIZE(capacity, elem_size));
+        FUZZ_CHECK(storage && rb_init_static(&rb, storage, capacity, elem_size));
+    } else {
+        FUZZ_CHECK(rb_init(&rb, capacity, elem_size));
+    }
+
+    size_t ops = next_byte(in);
+    for (size_t i = 0; i < ops && in->size > 0; i++) {
+        uint8_t op = next_byte(in);
+        memset(elem, next_byte(in), elem_size);
+        bool full = (model_size == capacity);
+        uint8_t *peek;
+
+        switch (op % 7) {
+            case 0:
+                FUZZ_CHECK(rb_push_back(&rb, elem) == !full);
+                if (!full) memcpy(model[model_size++], elem, elem_size);
+                break;
+            case 1:
+                FUZZ_CHECK(rb_push_front(&rb, elem) == !full);
+                if (!full) {
+                    memmove(model[1], model[0], model_size * sizeof(model[0]));
+                    memcpy(model[0], elem, elem_size);
+                    model_size++;
+                }
+                break;
+            case 2:
+                FUZZ_CHECK(rb_pop_front(&rb, (op & 8) ? elem : NULL) == (model_size > 0));
+                if (model_size > 0) {
+                    FUZZ_CHECK(!(op & 8) || memcmp(elem, model[0], elem_size) == 0);
+                    memmove(model[0], model[1], --model_size * sizeof(model[0]));
+                }
+                break;
+            case 3:
+                FUZZ_CHECK(rb_pop_back(&rb, (op & 8) ? elem : NULL) == (model_size > 0));
+                if (model_size > 0) {
+                    model_size--;
+                    FUZZ_CHECK(!(op & 8) || memcmp(elem, model[model_size], elem_size) == 0);
+                }
+                break;
+            case 4:
+                peek = rb_peek_front(&rb);
+                FUZZ_CHECK((peek != NULL) == (model_size > 0));
+                FUZZ_CHECK(!peek || memcmp(peek, model[0], elem_size) == 0);
+                break;
+            case 5:
+                peek = rb_peek_back(&rb);
+                FUZZ_CHECK((peek != NULL) == (model_size > 0));
+                FUZZ_CHECK(!peek || memcmp(peek, model[model_size - 1], elem_size) == 0);
+                break;
+            case 6:
+                rb_clear(&rb);
+                model_size = 0;
+                break;
+        }
+
+        FUZZ_CHECK(rb_size(&rb) == model_size);
+        FUZZ_CHECK(rb_capacity(&rb) == capacity);
+        FUZZ_CHECK(rb_is_empty(&rb) == (model_size == 0));
+        FUZZ_CHECK(rb_is_full(&rb) == (model_size == capacity));
+    }
+
+    rb_destroy(&rb);
+    free(storage);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    fuzz_input_t in = { data, size };
+
+    switch (next_byte(&in) % 3) {
+        case 0:
+            fuzz_pqc(&in);
+            break;
+        case 1:
+            fuzz_ll(&in);
+            break;
+        case 2:
+            fuzz_rb(&in);
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+// Prueba de estrés del wrapper de FreeRTOS sobre el kernel del proyecto, en host
+// con el port POSIX. Varios productores envían sin esperar, más rápido de lo que
+// saca un consumidor lento, así la cola pasa casi todo el tiempo llena. Una fase
+// por política de desborde, más una con envío bloqueante.
+// Después de cada envío y de cada recepción se verifica, en una sola sección
+// crítica, que el conteo que publica la cola (uxPriorityQueueMessagesWaiting)
+// sea pqc_size y que pushed == popped + discarded + size. Al cerrar cada fase,
+// que los contadores del core coincidan con lo que contaron las tareas.
+//
+//   make stress FREERTOS_POSIX=<FreeRTOS>/Source/portable/ThirdParty/GCC/Posix
+
+// Se incluye la implementación para comparar contra el core de la cola
+#include "../app/src/freertos_priority_queue.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STRESS_CAPACITY     8
+#define STRESS_PRODUCERS    3
+#define STRESS_BURST        4       // Envíos por tick de cada productor
+#define STRESS_PHASE_MS     2000
+#define STRESS_SEND_WAIT    2       // Ticks que espera un envío bloqueante
+
+#define STRESS_CHECK(cond)  configASSERT(cond)
+
+typedef struct {
+    pq_priority_t prio;
+    uint8_t producer;
+    uint32_t seq;
+} stress_msg_t;
+
+typedef struct {
+    const char *name;
+    pq_overflow_policy_t policy;
+    bool blocking;
+} stress_phase_t;
+
+static const stress_phase_t phases[] = {
+    { "drop_oldest", PQ_OVERFLOW_DROP_OLDEST, false },
+    { "drop_newest", PQ_OVERFLOW_DROP_NEWEST, false },
+    { "drop_lowest", PQ_OVERFLOW_DROP_LOWEST, false },
+    { "reject",      PQ_OVERFLOW_REJECT,      false },
+    { "blocking",    PQ_OVERFLOW_DROP_OLDEST, true  },
+};
+
+static PriorityQueueHandle_t queue;
+static volatile bool running;
+static volatile bool blocking;
+static volatile bool producing[STRESS_PRODUCERS];
+static volatile uint32_t sent[STRESS_PRODUCERS];    // Envíos con pdPASS
+static volatile uint32_t received;
+
+void vAssertCalled(const char *file, unsigned long line) {
+    fprintf(stderr, "stress_pq: falla en %s:%lu\n", file, line);
+    exit(1);
+}
+
+// Foto de la cola en una sola sección crítica, para no mezclar dos estados
+static void check_counts(void) {
+    pq_stats_t stats;
+    UBaseType_t waiting;
+    size_t size;
+
+    taskENTER_CRITICAL();
+    waiting = uxPriorityQueueMessagesWaiting(queue);
+    size = pqc_size(&queue->core);
+    vPriorityQueueGetStats(queue, &stats);
+    taskEXIT_CRITICAL();
+
+    STRESS_CHECK(waiting == size);
+    STRESS_CHECK(size <= STRESS_CAPACITY);
+    STRESS_CHECK(stats.pushed == stats.popped + stats.discarded + (uint32_t)size);
+}
+
+static uint32_t total_sent(void) {
+    uint32_t total = 0;
+    for (int i = 0; i < STRESS_PRODUCERS; i++) total += sent[i];
+    return total;
+}
+
+static void producer_task(void *argument) {
+    uint8_t id = (uint8_t)(uintptr_t)argument;
+    uint32_t seq = 0;
+
+    for (;;) {
+        // Se marca antes de mirar running: si el control ve la marca baja, este
+        // productor no va a enviar nada más en la fase
+        producing[id] = true;
+        if (running) {
+            TickType_t wait = blocking ? STRESS_SEND_WAIT : 0;
+            for (int i = 0; i < STRESS_BURST; i++) {
+                stress_msg_t msg = {
+                    .prio = (pq_priority_t)((seq + id) % PQ_PRIO__N),
+                    .producer = id,
+                    .seq = seq++,
+                };
+                if (xPriorityQueueSend(queue, &msg, wait) == pdPASS) sent[id]++;
+                check_counts();
+            }
+        }
+        producing[id] = false;
+        vTaskDelay(1);
+    }
+}
+
+static void consumer_task(void *argument) {
+    (void)argument;
+    for (;;) {
+        stress_msg_t msg;
+        // Sin timeout solo puede volver con un mensaje
+        STRESS_CHECK(xPriorityQueueReceive(queue, &msg, portMAX_DELAY) == pdPASS);
+        STRESS_CHECK(msg.producer < STRESS_PRODUCERS && msg.prio < PQ_PRIO__N);
+        received++;
+        check_counts();
+        vTaskDelay(1);
+    }
+}
+
+static void run_phase(const stress_phase_t *phase) {
+    pq_stats_t before, after;
+    uint32_t sent_before = total_sent();
+    uint32_t received_before = received;
+
+    vPriorityQueueGetStats(queue, &before);
+    vPriorityQueueSetOverflowPolicy(queue, phase->policy);
+    vPriorityQueueSetBlockingSend(queue, phase->blocking ? pdTRUE : pdFALSE);
+    blocking = phase->blocking;
+    running = true;
+    vTaskDelay(pdMS_TO_TICKS(STRESS_PHASE_MS));
+    running = false;
+
+    // Que terminen las ráfagas en curso y el consumidor vacíe la cola
+    for (int i = 0; i < STRESS_PRODUCERS; i++) {
+        while (producing[i]) vTaskDelay(1);
+    }
+    while (uxPriorityQueueMessagesWaiting(queue) > 0) vTaskDelay(1);
+    vTaskDelay(pdMS_TO_TICKS(10));
+    check_counts();
+
+    vPriorityQueueGetStats(queue, &after);
+    uint32_t pushed = after.pushed - before.pushed;
+    uint32_t popped = after.popped - before.popped;
+    uint32_t discarded = after.discarded - before.discarded;
+    uint32_t overflows = after.overflow_drops[phase->policy] - before.overflow_drops[phase->policy];
+
+    STRESS_CHECK(pushed == total_sent() - sent_before);
+    STRESS_CHECK(popped == received - received_before);
+    STRESS_CHECK(pushed == popped + discarded);
+    if (phase->blocking) {
+        // Esperando lugar nunca se descarta un mensaje encolado
+        STRESS_CHECK(discarded == 0);
+    } else {
+        // La cola estuvo desbordada de verdad
+        STRESS_CHECK(overflows > 0);
+    }
+
+    // En el port POSIX, la libc solo dentro de una sección crítica
+    taskENTER_CRITICAL();
+    printf("stress_pq: %-11s %7lu enviados %7lu recibidos %7lu descartados %7lu desbordes\n",
+           phase->name, (unsigned long)pushed, (unsigned long)popped,
+           (unsigned long)discarded, (unsigned long)overflows);
+    fflush(stdout);
+    taskEXIT_CRITICAL();
+}
+
+static void control_task(void *argument) {
+    (void)argument;
+    for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+        run_phase(&phases[i]);
+    }
+    taskENTER_CRITICAL();
+    puts("stress_pq: ok");
+    exit(0);
+}
+
+int main(void) {
+    queue = xPriorityQueueCreate(STRESS_CAPACITY, sizeof(stress_msg_t));
+    STRESS_CHECK(queue != NULL);
+
+    // Control > productores > consumidor: el consumidor solo corre en los huecos
+    for (int i = 0; i < STRESS_PRODUCERS; i++) {
+        STRESS_CHECK(xTaskCreate(producer_task, "producer", configMINIMAL_STACK_SIZE,
+                                 (void *)(uintptr_t)i, tskIDLE_PRIORITY + 2, NULL) == pdPASS);
+    }
+    STRESS_CHECK(xTaskCreate(consumer_task, "consumer", configMINIMAL_STACK_SIZE,
+                             NULL, tskIDLE_PRIORITY + 1, NULL) == pdPASS);
+    STRESS_CHECK(xTaskCreate(control_task, "control", configMINIMAL_STACK_SIZE,
+                             NULL, tskIDLE_PRIORITY + 3, NULL) == pdPASS);
+
+    vTaskStartScheduler();
+    return 1;   // Sin memoria para la tarea idle
+}
@@ -0,0 +1,192 @@
+// Prueba diferencial del core contra un modelo de referencia (host, gcc).
+// Corre secuencias aleatorias de pqc_init/pqc_push/pqc_pop/pqc_destroy con
+// capacidades chicas y compara cada resultado con el modelo: FIFO dentro de un
+// nivel, prioridad estricta entre niveles y descarte del más antiguo con la cola
+// llena. Cada payload es un bloque de malloc: las liberaciones por free_cb y por
+// pop se cuentan para detectar pérdidas y dobles liberaciones.
+//
+// Uso: test_pqc_model [operaciones] [semilla]
+
+#include "priority_queue_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MODEL_MAX_CAPACITY  16
+#define OPS_PER_ROUND       5000UL
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: falló '%s' (semilla %lu, operación %lu)\n", \
+                __FILE__, __LINE__, #cond, seed, op_index); \
+        exit(1); \
+    } \
+} while (0)
+
+typedef struct {
+    unsigned id;
+    pq_priority_t prio;
+    unsigned long arrival;
+} model_entry_t;
+
+// Modelo: los elementos encolados, sin orden particular (la capacidad es chica)
+static model_entry_t model[MODEL_MAX_CAPACITY];
+static size_t model_size;
+static unsigned long arrivals;
+
+static unsigned long seed;
+static unsigned long op_index;
+static uint32_t rng;
+
+static unsigned long allocs;
+static unsigned long frees;
+static long expected_free;      // id que tiene que liberar free_cb, -1 = ninguno
+static bool destroying;         // En pqc_destroy se libera lo pendiente, en cualquier orden
+
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void model_remove(size_t i) {
+    model[i] = model[--model_size];
+}
+
+static size_t model_find(unsigned id) {
+    for (size_t i = 0; i < model_size; i++) {
+        if (model[i].id == id) return i;
+    }
+    return model_size;
+}
+
+// Índice del modelo que tiene que salir: el nivel más urgente y, dentro de él,
+// el más antiguo
+static size_t model_front(void) {
+    size_t best = 0;
+    for (size_t i = 1; i < model_size; i++) {
+        if (model[i].prio < model[best].prio ||
+            (model[i].prio == model[best].prio && model[i].arrival < model[best].arrival)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static size_t model_oldest(void) {
+    size_t oldest = 0;
+    for (size_t i = 1; i < model_size; i++) {
+        if (model[i].arrival < model[oldest].arrival) oldest = i;
+    }
+    return oldest;
+}
+
+static unsigned *new_payload(unsigned id) {
+    unsigned *payload = malloc(sizeof(*payload));
+    CHECK(payload != NULL);
+    *payload = id;
+    allocs++;
+    return payload;
+}
+
+// free_cb: solo puede liberar el elemento que el modelo espera descartar
+static void free_payload(void *payload) {
+    unsigned id = *(unsigned*)payload;
+
+    if (destroying) {
+        size_t i = model_find(id);
+        CHECK(i < model_size);
+        model_remove(i);
+    } else {
+        CHECK(expected_free == (long)id);
+        expected_free = -1;
+    }
+
+    free(payload);
+    frees++;
+}
+
+static void do_push(priority_queue_core_t *pq, size_t capacity, unsigned *next_id) {
+    unsigned id = (*next_id)++;
+    pq_item_t item = {
+        .prio = (pq_priority_t)(next_rand() % PQ_PRIO__N),
+        .payload = new_payload(id),
+        .free_cb = free_payload,
+    };
+
+    // Cola llena: la política por defecto descarta el más antiguo de toda la cola
+    if (model_size == capacity) {
+        size_t oldest = model_oldest();
+        expected_free = model[oldest].id;
+        model_remove(oldest);
+    }
+
+    CHECK(pqc_push(pq, &item));
+    CHECK(expected_free == -1);
+
+    model[model_size++] = (model_entry_t){ .id = id, .prio = item.prio, .arrival = arrivals++ };
+}
+
+static void do_pop(priority_queue_core_t *pq) {
+    pq_item_t out;
+    bool popped = pqc_pop(pq, &out);
+
+    CHECK(popped == (model_size > 0));
+    if (!popped) return;
+
+    size_t front = model_front();
+    CHECK(out.payload != NULL);
+    CHECK(*(unsigned*)out.payload == model[front].id);
+    CHECK(out.prio == model[front].prio);
+    model_remove(front);
+
+    // Un elemento sacado es del llamador: se libera acá, no con free_cb
+    free(out.payload);
+    frees++;
+}
+
+static void run_round(unsigned long ops) {
+    priority_queue_core_t pq;
+    size_t capacity = 1 + next_rand() % MODEL_MAX_CAPACITY;
+    unsigned next_id = 0;
+
+    CHECK(pqc_init(&pq, capacity));
+    model_size = 0;
+    expected_free = -1;
+
+    // Proporción de push variable por ronda: colas casi vacías y casi siempre llenas
+    uint32_t push_weight = 1 + next_rand() % 7;
+
+    for (unsigned long i = 0; i < ops; i++, op_index++) {
+        if (next_rand() % 8 < push_weight) {
+            do_push(&pq, capacity, &next_id);
+        } else {
+            do_pop(&pq);
+        }
+        CHECK(pqc_size(&pq) == model_size);
+        CHECK(pqc_is_full(&pq) == (model_size == capacity));
+        CHECK(pqc_check_invariants(&pq));
+    }
+
+    destroying = true;
+    pqc_destroy(&pq);
+    destroying = false;
+
+    CHECK(model_size == 0);
+    CHECK(frees == allocs);
+}
+
+int main(int argc, char **argv) {
+    unsigned long total_ops = (argc > 1) ? strtoul(argv[1], NULL, 0) : 2000000UL;
+    seed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+    rng = (uint32_t)seed ? (uint32_t)seed : 1;
+
+    while (op_index < total_ops) {
+        unsigned long ops = total_ops - op_index;
+        run_round(ops < OPS_PER_ROUND ? ops : OPS_PER_ROUND);
+    }
+
+    printf("test_pqc_model: %lu operaciones OK (semilla %lu, %lu payloads)\n", op_index, seed, allocs);
+    return 0;
+}
@@ -0,0 +1,145 @@
+// seq_counter arranca cerca de UINT32_MAX y da la vuelta en medio de cada
+// prueba: el orden de llegada (descarte del más antiguo, FIFO dentro de un
+// nivel y desempate de EDF) tiene que seguir siendo el mismo.
+
+#include "priority_queue_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CAPACITY    4
+#define PUSHES      12
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: falló '%s'\n", __FILE__, __LINE__, #cond); \
+        exit(1); \
+    } \
+} while (0)
+
+static int ids[PUSHES];
+static int freed[PUSHES];
+static int freed_count;
+
+static void record_free(void *payload) {
+    freed[freed_count++] = *(int*)payload;
+}
+
+static void init_queue(priority_queue_core_t *pq, pq_mode_t mode, pq_overflow_policy_t policy) {
+    CHECK(pqc_init(pq, CAPACITY));
+    CHECK(pqc_set_mode(pq, mode));
+    CHECK(pqc_set_overflow_policy(pq, policy));
+
+    // Da la vuelta después de los primeros 3 push
+    pq->seq_counter = UINT32_MAX - 2;
+    freed_count = 0;
+}
+
+static void push(priority_queue_core_t *pq, int id, pq_priority_t prio, uint32_t deadline) {
+    pq_item_t item = {
+        .prio = prio,
+        .deadline = deadline,
+        .payload = &ids[id],
+        .free_cb = record_free,
+    };
+    CHECK(pqc_push(pq, &item));
+    CHECK(pqc_check_invariants(pq));
+}
+
+static int pop_id(priority_queue_core_t *pq) {
+    pq_item_t out;
+    CHECK(pqc_pop(pq, &out));
+    CHECK(pqc_check_invariants(pq));
+    return *(int*)out.payload;
+}
+
+// Con la cola llena se descarta siempre el más antiguo, en orden de llegada,
+// aunque su seq sea "mayor" que el de los que llegaron después de la vuelta
+static void test_drop_oldest(void) {
+    priority_queue_core_t pq;
+    init_queue(&pq, PQ_MODE_LEVELS, PQ_OVERFLOW_DROP_OLDEST);
+
+    for (int id = 0; id < PUSHES; id++) {
+        push(&pq, id, (pq_priority_t)(id % PQ_PRIO__N), 0);
+    }
+
+    CHECK(freed_count == PUSHES - CAPACITY);
+    for (int i = 0; i < freed_count; i++) {
+        CHECK(freed[i] == i);
+    }
+
+    pqc_destroy(&pq);
+}
+
+// Dentro de un nivel, FIFO a través de la vuelta
+static void test_fifo_within_level(void) {
+    priority_queue_core_t pq;
+    init_queue(&pq, PQ_MODE_LEVELS, PQ_OVERFLOW_DROP_OLDEST);
+
+    for (int round = 0; round < 3; round++) {
+        for (int id = 0; id < CAPACITY; id++) {
+            push(&pq, id, PQ_PRIO_MED, 0);
+        }
+        for (int id = 0; id < CAPACITY; id++) {
+            CHECK(pop_id(&pq) == id);
+        }
+    }
+    CHECK(freed_count == 0);
+
+    pqc_destroy(&pq);
+}
+
+// Descarte del más antiguo del nivel menos urgente, a través de la vuelta
+static void test_drop_lowest(void) {
+    priority_queue_core_t pq;
+    init_queue(&pq, PQ_MODE_LEVELS, PQ_OVERFLOW_DROP_LOWEST);
+
+    push(&pq, 0, PQ_PRIO_LOW, 0);
+    push(&pq, 1, PQ_PRIO_HIGH, 0);
+    push(&pq, 2, PQ_PRIO_LOW, 0);
+    push(&pq, 3, PQ_PRIO_LOW, 0);       // Primer seq después de la vuelta
+    push(&pq, 4, PQ_PRIO_HIGH, 0);
+    push(&pq, 5, PQ_PRIO_HIGH, 0);
+
+    CHECK(freed_count == 2);
+    CHECK(freed[0] == 0);
+    CHECK(freed[1] == 2);
+
+    pqc_destroy(&pq);
+}
+
+// EDF: mismo deadline desempata por llegada; los deadlines también dan la vuelta
+static void test_edf(void) {
+    priority_queue_core_t pq;
+    init_queue(&pq, PQ_MODE_EDF, PQ_OVERFLOW_DROP_OLDEST);
+
+    for (int id = 0; id < CAPACITY; id++) {
+        push(&pq, id, PQ_PRIO_MED, 100);
+    }
+    for (int id = 0; id < CAPACITY; id++) {
+        CHECK(pop_id(&pq) == id);
+    }
+
+    push(&pq, 0, PQ_PRIO_MED, 5);                   // Después de la vuelta del deadline
+    push(&pq, 1, PQ_PRIO_MED, UINT32_MAX - 5);      // Antes de la vuelta: sale primero
+    push(&pq, 2, PQ_PRIO_MED, 5);
+    CHECK(pop_id(&pq) == 1);
+    CHECK(pop_id(&pq) == 0);
+    CHECK(pop_id(&pq) == 2);
+
+    pqc_destroy(&pq);
+}
+
+int main(void) {
+    for (int id = 0; id < PUSHES; id++) {
+        ids[id] = id;
+    }
+
+    test_drop_oldest();
+    test_fifo_within_level();
+    test_drop_lowest();
+    test_edf();
+
+    printf("test_seq_wrap: OK\n");
+    return 0;
+}